@@ -0,0 +1,94 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Minimal Arduino API for building the firmware on a host (see the replay env in platformio.ini)
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "avr/pgmspace.h"
+
+#define F_CPU 16000000UL
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template<class T, class L>
+auto min(const T &a, const L &b) -> decltype(b < a ? b : a) {
+  return b < a ? b : a;
+}
+
+template<class T, class L>
+auto max(const T &a, const L &b) -> decltype(b < a ? b : a) {
+  return a < b ? b : a;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+uint8_t digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+inline void cli() {}
+inline void sei() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    size_t write(const char *str);
+    size_t write(const uint8_t *buffer, size_t size);
+
+    size_t print(const __FlashStringHelper *str);
+    size_t print(const char *str);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = 10);
+    size_t print(int n, int base = 10);
+    size_t print(unsigned int n, int base = 10);
+    size_t print(long n, int base = 10);
+    size_t print(unsigned long n, int base = 10);
+    size_t print(double n, int digits = 2);
+
+    size_t println();
+    template<class T> size_t println(T value) {
+      return print(value) + println();
+    }
+};
+
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    int available();
+    int read();
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// Simulation controls
+void hostUseRealTime(); // millis() and delay() follow the real clock instead of hostSetMillis()
+void hostSerialFromStdin(); // Serial reads stdin without blocking instead of hostSerialInput()
+void hostSetMillis(uint32_t ms);
+void hostSetPin(uint8_t pin, int level);
+void hostTriggerInterrupt(uint8_t pin);
+void hostSerialInput(const uint8_t *data, size_t length);
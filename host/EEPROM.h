@@ -0,0 +1,31 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass {
+  public:
+    EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+    uint8_t read(int addr) { return data[addr]; }
+    void write(int addr, uint8_t value) { data[addr] = value; }
+    void update(int addr, uint8_t value) { data[addr] = value; }
+    uint16_t length() { return sizeof(data); }
+
+    template<class T> T &get(int addr, T &t) {
+      memcpy((void *)&t, &data[addr], sizeof(T));
+      return t;
+    }
+
+    template<class T> const T &put(int addr, const T &t) {
+      memcpy(&data[addr], (const void *)&t, sizeof(T));
+      return t;
+    }
+
+  private:
+    uint8_t data[1024];
+};
+
+extern EEPROMClass EEPROM;
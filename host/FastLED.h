@@ -0,0 +1,77 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// The parts of FastLED used by the firmware, with the same results as FastLED's C implementations
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+typedef uint16_t fract16;
+
+struct CRGB {
+  uint8_t r, g, b;
+  inline CRGB() {}
+  inline CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+};
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+  return ((uint16_t)i * (1 + scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+  return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+#define scale8_LEAVING_R1_DIRTY scale8
+#define scale8_video_LEAVING_R1_DIRTY scale8_video
+inline void cleanup_R1() {}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+  unsigned int t = i + j;
+  return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+  return i > j ? i - j : 0;
+}
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac) {
+  if (b > a) return a + scale8(b - a, frac);
+  else return a - scale8(a - b, frac);
+}
+
+uint8_t sin8(uint8_t theta);
+int16_t sin16(uint16_t theta);
+inline int16_t cos16(uint16_t theta) {
+  return sin16(theta + 16384);
+}
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z);
+extern uint32_t hostNoiseCalls; // Host only, number of inoise8() calls
+uint16_t random16();
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint8_t random8(uint8_t min, uint8_t lim);
+
+template<uint8_t DATA_PIN> class WS2812B {};
+
+class CFastLED {
+  public:
+    template<template<uint8_t> class CHIPSET, uint8_t DATA_PIN>
+    void addLeds(CRGB *data, int count) {
+      leds = data;
+      ledCount = count;
+    }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() { return brightness; }
+    void show() { frames++; }
+
+    // Host only, for inspecting output
+    CRGB *leds = nullptr;
+    int ledCount = 0;
+    uint8_t brightness = 255;
+    uint32_t frames = 0;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,54 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Display driver that accepts every call and draws nothing
+
+#pragma once
+
+#include <Arduino.h>
+
+struct u8x8_t {};
+struct u8g2_cb_t {};
+extern const u8g2_cb_t u8g2_cb_r2;
+#define U8G2_R2 (&u8g2_cb_r2)
+
+extern const uint8_t u8g2_font_logisoso16_tr[];
+extern const uint8_t u8g2_font_profont12_tr[];
+
+inline void u8x8_cad_StartTransfer(u8x8_t *) {}
+inline void u8x8_cad_SendCmd(u8x8_t *, uint8_t) {}
+inline void u8x8_cad_SendArg(u8x8_t *, uint8_t) {}
+inline void u8x8_cad_EndTransfer(u8x8_t *) {}
+
+class U8G2_SSD1306_128X32_UNIVISION_F_HW_I2C : public Print {
+  public:
+    U8G2_SSD1306_128X32_UNIVISION_F_HW_I2C(const u8g2_cb_t *) {}
+    void begin() {}
+    u8x8_t *getU8x8() { return &u8x8; }
+    uint8_t getDisplayWidth() { return 128; }
+    uint8_t getDisplayHeight() { return 32; }
+    uint8_t getBufferTileWidth() { return 16; }
+    uint8_t getBufferTileHeight() { return 4; }
+
+    void setFont(const uint8_t *) {}
+    void setFontMode(uint8_t) {}
+    void setDrawColor(uint8_t) {}
+    void setContrast(uint8_t) {}
+    void setCursor(int16_t, int16_t) {}
+    uint16_t drawStr(int16_t, int16_t, const char *) { return 0; }
+    void drawBox(int16_t, int16_t, int16_t, int16_t) {}
+    void drawFrame(int16_t, int16_t, int16_t, int16_t) {}
+    void drawTriangle(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t) {}
+    size_t write(uint8_t) override { return 1; }
+
+    void clearBuffer() {}
+    void clear() { tilesSent += 64; }
+    void sendBuffer() { tilesSent += 64; }
+    void updateDisplayArea(uint8_t, uint8_t, uint8_t w, uint8_t h) { tilesSent += w * h; }
+
+    // Host only
+    uint32_t tilesSent = 0; // 8 bytes each
+
+  private:
+    u8x8_t u8x8;
+};
@@ -0,0 +1,15 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <string.h>
+
+// Flash and RAM are the same thing on a host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(addr))
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define memcpy_P memcpy
@@ -0,0 +1,303 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <FastLED.h>
+#include <U8g2lib.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+CFastLED FastLED;
+const u8g2_cb_t u8g2_cb_r2 = {};
+const uint8_t u8g2_font_logisoso16_tr[] = {0};
+const uint8_t u8g2_font_profont12_tr[] = {0};
+
+// millis() follows the simulated clock so replays are deterministic,
+// micros() follows the real clock so stage timings can be profiled
+static bool realTime = false;
+static bool stdinSerial = false;
+static uint32_t simulatedMillis = 0;
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+static uint8_t pinLevels[32];
+static void (*interruptHandlers[32])();
+static std::deque<uint8_t> serialInput;
+static uint16_t rand16seed = 1337;
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+uint32_t millis() {
+  return realTime ? micros() / 1000 : simulatedMillis;
+}
+
+uint32_t micros() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now() - startTime).count();
+}
+
+void delay(uint32_t ms) {
+  if (realTime) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  else simulatedMillis += ms;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (mode == INPUT_PULLUP) pinLevels[pin] = HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+  return pinLevels[pin];
+}
+
+uint8_t digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int) {
+  interruptHandlers[interrupt] = isr;
+}
+
+void hostUseRealTime() {
+  realTime = true;
+}
+
+void hostSerialFromStdin() {
+  fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+  setvbuf(stdout, nullptr, _IONBF, 0);
+  stdinSerial = true;
+}
+
+void hostSetMillis(uint32_t ms) {
+  simulatedMillis = ms;
+}
+
+void hostSetPin(uint8_t pin, int level) {
+  pinLevels[pin] = level;
+}
+
+void hostTriggerInterrupt(uint8_t pin) {
+  if (interruptHandlers[pin]) interruptHandlers[pin]();
+}
+
+void hostSerialInput(const uint8_t *data, size_t length) {
+  serialInput.insert(serialInput.end(), data, data + length);
+}
+
+// Print
+
+size_t Print::write(const char *str) {
+  size_t n = 0;
+  while (*str) n += write(*str++);
+  return n;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+  return write((const char *)str);
+}
+
+size_t Print::print(const char *str) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write(c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base) {
+  return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base) {
+  if (n < 0) return write('-') + print((unsigned long)-n, base);
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buffer[8 * sizeof(long) + 1];
+  char *str = &buffer[sizeof(buffer) - 1];
+  *str = '\0';
+  do {
+    char digit = n % base;
+    n /= base;
+    *--str = digit < 10 ? digit + '0' : digit + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+  return write(buffer);
+}
+
+size_t Print::println() {
+  return write('\n');
+}
+
+int HardwareSerial::available() {
+  if (stdinSerial) {
+    uint8_t buffer[64];
+    ssize_t n = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (n > 0) serialInput.insert(serialInput.end(), buffer, buffer + n);
+  }
+  return serialInput.size();
+}
+
+int HardwareSerial::read() {
+  if (serialInput.empty()) return -1;
+  uint8_t c = serialInput.front();
+  serialInput.pop_front();
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+// FastLED
+
+uint8_t sin8(uint8_t theta) {
+  static const uint8_t interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+  uint8_t offset = theta;
+  if (theta & 0x40) offset = 255 - offset;
+  offset &= 0x3F;
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40) secoffset++;
+  uint8_t section = offset >> 4;
+  uint8_t b = interleave[section * 2];
+  uint8_t m16 = interleave[section * 2 + 1];
+  int8_t y = ((m16 * secoffset) >> 4) + b;
+  if (theta & 0x80) y = -y;
+  return y + 128;
+}
+
+int16_t sin16(uint16_t theta) {
+  static const uint16_t base[] = {0, 6393, 12539, 18204, 23170, 27245, 30273, 32137};
+  static const uint8_t slope[] = {49, 48, 44, 38, 31, 23, 14, 4};
+  uint16_t offset = (theta & 0x3FFF) >> 3;
+  if (theta & 0x4000) offset = 2047 - offset;
+  uint8_t section = offset / 256;
+  uint8_t secoffset8 = (uint8_t)offset / 2;
+  int16_t y = slope[section] * secoffset8 + base[section];
+  if (theta & 0x8000) y = -y;
+  return y;
+}
+
+// Perlin's permutation, repeated once so P(i + 1) works for i = 255
+static const uint8_t noisePermutation[] = {
+  151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+  140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+  247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+  57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+  74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+  60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+  65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+  200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+  52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+  207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+  119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+  129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+  218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+  81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+  184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+  222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+  151
+};
+
+static uint8_t ease8InOutQuad(uint8_t i) {
+  uint8_t j = i & 0x80 ? 255 - i : i;
+  uint8_t jj2 = scale8(j, j) << 1;
+  return i & 0x80 ? 255 - jj2 : jj2;
+}
+
+static int8_t avg7(int8_t i, int8_t j) {
+  return (i >> 1) + (j >> 1) + (i & 0x1);
+}
+
+static int8_t lerp7by8(int8_t a, int8_t b, fract8 frac) {
+  if (b > a) return a + scale8(b - a, frac);
+  else return a - scale8(a - b, frac);
+}
+
+static int8_t grad8(uint8_t hash, int8_t x, int8_t y, int8_t z) {
+  hash &= 0xF;
+  int8_t u = hash & 8 ? y : x;
+  int8_t v = hash < 4 ? y : hash == 12 || hash == 14 ? x : z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg7(u, v);
+}
+
+uint32_t hostNoiseCalls = 0;
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z) {
+  hostNoiseCalls++;
+  const uint8_t *p = noisePermutation;
+  uint8_t X = x >> 8;
+  uint8_t Y = y >> 8;
+  uint8_t Z = z >> 8;
+  uint8_t A = p[X] + Y;
+  uint8_t AA = p[A] + Z;
+  uint8_t AB = p[A + 1] + Z;
+  uint8_t B = p[X + 1] + Y;
+  uint8_t BA = p[B] + Z;
+  uint8_t BB = p[B + 1] + Z;
+
+  int8_t xx = ((uint8_t)x >> 1) & 0x7F;
+  int8_t yy = ((uint8_t)y >> 1) & 0x7F;
+  int8_t zz = ((uint8_t)z >> 1) & 0x7F;
+  uint8_t N = 0x80;
+  uint8_t u = ease8InOutQuad(x);
+  uint8_t v = ease8InOutQuad(y);
+  uint8_t w = ease8InOutQuad(z);
+
+  int8_t X1 = lerp7by8(grad8(p[AA], xx, yy, zz), grad8(p[BA], xx - N, yy, zz), u);
+  int8_t X2 = lerp7by8(grad8(p[AB], xx, yy - N, zz), grad8(p[BB], xx - N, yy - N, zz), u);
+  int8_t X3 = lerp7by8(grad8(p[AA + 1], xx, yy, zz - N), grad8(p[BA + 1], xx - N, yy, zz - N), u);
+  int8_t X4 = lerp7by8(grad8(p[AB + 1], xx, yy - N, zz - N),
+                       grad8(p[BB + 1], xx - N, yy - N, zz - N), u);
+  int8_t Y1 = lerp7by8(X1, X2, v);
+  int8_t Y2 = lerp7by8(X3, X4, v);
+  int8_t n = lerp7by8(Y1, Y2, w) + 64;
+  return qadd8(n, n);
+}
+
+uint16_t random16() {
+  rand16seed = rand16seed * 2053 + 13849;
+  return rand16seed;
+}
+
+uint8_t random8() {
+  random16();
+  return (uint8_t)((uint8_t)(rand16seed & 0xFF) + (uint8_t)(rand16seed >> 8));
+}
+
+uint8_t random8(uint8_t lim) {
+  return (random8() * lim) >> 8;
+}
+
+uint8_t random8(uint8_t min, uint8_t lim) {
+  return random8(lim - min) + min;
+}
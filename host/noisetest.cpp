@@ -0,0 +1,117 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Checks NoiseStrip on the host: how far the cached samples are from calling inoise8 for every
+// pixel, that the pattern loops, and how many inoise8 calls each frame takes
+// Usage: noisetest, exits with 1 if anything fails
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <FastLED.h>
+
+#include "../src/constants.hpp"
+#include "../src/noise.hpp"
+
+const uint16_t NoiseTestFrames = 2000;
+const uint8_t NoiseTestMaxError = 12; // largest difference from direct lookups allowed
+const uint8_t NoiseTestMaxStep = 32; // largest change of one pixel between frames at the wrap
+
+static uint8_t failures = 0;
+
+// Same mapping as Glowstick::drawNoiseFrame at scale 1
+struct NoiseTestPattern {
+  const char *name;
+  uint8_t timeCells;
+  uint8_t spaceShift;
+};
+
+static uint16_t position(uint8_t i, uint8_t spaceShift) {
+  uint16_t positionStep = 65536.0 / LEDCount;
+  return ((uint32_t)i * positionStep >> 8) << spaceShift;
+}
+
+static void checkPattern(const NoiseTestPattern &pattern, uint16_t phaseStep) {
+  NoiseStrip cached, direct;
+  uint16_t first = position(0, pattern.spaceShift);
+  uint16_t last = position(LEDCount - 1, pattern.spaceShift);
+  uint32_t calls = 0, maxCalls = 0, framesWithCalls = 0;
+  uint32_t totalError = 0;
+  uint8_t maxError = 0;
+
+  for (uint16_t frame = 0; frame < NoiseTestFrames; frame++) {
+    uint16_t phase = frame * phaseStep;
+    uint32_t before = hostNoiseCalls;
+    cached.begin(phase, pattern.timeCells, first, last);
+    uint8_t values[LEDCount];
+    for (uint8_t i = 0; i < LEDCount; i++) values[i] = cached.get(position(i, pattern.spaceShift));
+    uint32_t frameCalls = hostNoiseCalls - before;
+    if (frame > 0) {
+      calls += frameCalls;
+      if (frameCalls > maxCalls) maxCalls = frameCalls;
+      if (frameCalls > 0) framesWithCalls++;
+    }
+
+    // Reference: inoise8 at every pixel, at exactly this phase
+    uint16_t span = (uint16_t)NoiseSamples << (NoiseMaxSampleShift + 1);
+    direct.begin(phase, pattern.timeCells, 0, span);
+    for (uint8_t i = 0; i < LEDCount; i++) {
+      uint8_t error = abs(values[i] - direct.get(position(i, pattern.spaceShift)));
+      totalError += error;
+      if (error > maxError) maxError = error;
+    }
+  }
+
+  // Last frame of a cycle and the first of the next must be close
+  uint8_t maxStep = 0;
+  uint8_t before[LEDCount];
+  cached.begin(65536 - phaseStep, pattern.timeCells, first, last);
+  for (uint8_t i = 0; i < LEDCount; i++) before[i] = cached.get(position(i, pattern.spaceShift));
+  cached.begin(0, pattern.timeCells, first, last);
+  for (uint8_t i = 0; i < LEDCount; i++) {
+    uint8_t step = abs(before[i] - cached.get(position(i, pattern.spaceShift)));
+    if (step > maxStep) maxStep = step;
+  }
+
+  printf("%-8s step %5u: error avg %.2f max %3u, wrap step %3u, inoise8 calls/frame avg %.2f "
+         "max %2u, %u of %u frames\n", pattern.name, phaseStep,
+         (double)totalError / (NoiseTestFrames * LEDCount), maxError, maxStep,
+         (double)calls / (NoiseTestFrames - 1), maxCalls, framesWithCalls, NoiseTestFrames - 1);
+  if (maxError > NoiseTestMaxError) {
+    printf("FAIL %s: max error %u\n", pattern.name, maxError);
+    failures++;
+  }
+  if (maxStep > NoiseTestMaxStep) {
+    printf("FAIL %s: wrap step %u\n", pattern.name, maxStep);
+    failures++;
+  }
+  // At most one new row per frame unless a frame skips past a whole keyframe
+  uint16_t keyframeStep = 65536 / (pattern.timeCells * NoiseKeyframesPerCell);
+  if (phaseStep < keyframeStep && maxCalls > NoiseSamples) {
+    printf("FAIL %s: %u inoise8 calls in one frame\n", pattern.name, maxCalls);
+    failures++;
+  }
+}
+
+int main() {
+  const NoiseTestPattern patterns[] = {{"plasma", 4, 2}, {"lava", 1, 1}};
+  // About 0.2hz and 3hz at 100fps
+  for (const NoiseTestPattern &pattern : patterns) {
+    checkPattern(pattern, 131);
+    checkPattern(pattern, 1966);
+  }
+
+  // Shimmer is too fine for the grid and looks up every pixel
+  NoiseStrip shimmer;
+  uint32_t before = hostNoiseCalls;
+  shimmer.begin(1000, 16, position(0, 4), position(LEDCount - 1, 4));
+  for (uint8_t i = 0; i < LEDCount; i++) shimmer.get(position(i, 4));
+  uint32_t calls = hostNoiseCalls - before;
+  printf("shimmer: inoise8 calls/frame %u\n", calls);
+  if (calls != LEDCount) {
+    printf("FAIL shimmer: expected %u calls\n", LEDCount);
+    failures++;
+  }
+
+  printf(failures ? "%u failed\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
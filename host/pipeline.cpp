@@ -0,0 +1,167 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Runs the firmware with the output stage on its own thread, the way a target with a second core
+// or a DMA LED driver would, and compares it with the sequential pipeline used on the ATmega328
+// Usage: pipeline [frames] [send us] [extra render us]
+// send us is how long sending one frame takes, the default is WS2812 timing for LEDCount LEDs
+// extra render us simulates a slower CPU by busy waiting after each frame is rendered
+// Also pushes frames through FrameHandoff as fast as possible and checks that none were torn,
+// lost or repeated, build with -fsanitize=thread to check the handoff for data races too
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+#include "../src/glowstick.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+static uint32_t sendTime = LEDCount * 32 * 5 / 4; // 32 bits at 1.25us each
+
+static void spin(uint32_t us) {
+  Clock::time_point end = Clock::now() + std::chrono::microseconds(us);
+  while (Clock::now() < end) {}
+}
+
+// Sending blocks the render loop, like FastLED.show() does on the ATmega328
+class BlockingOutput : public FrameOutput {
+  public:
+    void begin(RGBW *, uint16_t) {}
+    void show(uint8_t) { spin(sendTime); }
+};
+
+// Sends the previous frame from a second thread while the next one is rendered
+// Sending sleeps instead of spinning, like a DMA driver or second core it doesn't take render time
+class ThreadedOutput : public FrameOutput {
+  public:
+    void begin(RGBW *frame, uint16_t) {
+      this->frame = frame;
+      running = true;
+      thread = std::thread(&ThreadedOutput::run, this);
+    }
+
+    void show(uint8_t brightness) {
+      while (!handoff.ready()) std::this_thread::yield();
+      handoff.publish(frame, brightness);
+    }
+
+    void stop() {
+      while (!handoff.ready()) std::this_thread::yield();
+      running = false;
+      thread.join();
+    }
+
+  private:
+    void run() {
+      uint8_t brightness;
+      while (running) {
+        if (!handoff.take(brightness)) {
+          std::this_thread::yield();
+          continue;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(sendTime));
+      }
+    }
+
+    FrameHandoff<LEDCount> handoff;
+    RGBW *frame = nullptr;
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
+
+static uint32_t now = 0;
+
+static void runFor(Glowstick &device, uint32_t ms) {
+  for (uint32_t end = now + ms; now < end; now++) {
+    hostSetMillis(now);
+    device.tick();
+  }
+}
+
+// Steps through the menus to the first animation and then times frames back to back
+static double timeFrames(Glowstick &device, uint32_t frames, uint32_t renderTime) {
+  device.init();
+  for (uint8_t i = 0; i < MenuItemAnimation; i++) {
+    hostSetPin(PinEncoderB, LOW);
+    hostTriggerInterrupt(PinEncoderA);
+    runFor(device, 50);
+  }
+  for (uint8_t i = 0; i < 2; i++) {
+    hostSetPin(PinEncoderButton, LOW);
+    runFor(device, 50);
+    hostSetPin(PinEncoderButton, HIGH);
+    runFor(device, 50);
+  }
+
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < frames; i++) {
+    now += UpdateInterval;
+    hostSetMillis(now);
+    device.tick();
+    spin(renderTime);
+  }
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static RGBW testPattern(uint32_t frame, uint8_t index) {
+  return RGBW(frame, frame >> 8, frame * 7 + index, ~frame);
+}
+
+// Returns the number of frames that didn't arrive intact and in order
+static uint32_t checkHandoff(uint32_t frames) {
+  static FrameHandoff<LEDCount> handoff;
+  uint32_t errors = 0;
+  std::thread consumer([&] {
+    uint32_t expected = 0;
+    while (expected < frames) {
+      uint8_t brightness;
+      const RGBW *frame = handoff.take(brightness);
+      if (!frame) {
+        std::this_thread::yield();
+        continue;
+      }
+      bool intact = brightness == (uint8_t)expected;
+      for (uint8_t i = 0; i < LEDCount; i++) {
+        RGBW pixel = testPattern(expected, i);
+        intact &= frame[i].r == pixel.r && frame[i].g == pixel.g &&
+                  frame[i].b == pixel.b && frame[i].w == pixel.w;
+      }
+      if (!intact) errors++;
+      expected++;
+    }
+  });
+
+  RGBW frame[LEDCount];
+  for (uint32_t i = 0; i < frames; i++) {
+    for (uint8_t j = 0; j < LEDCount; j++) frame[j] = testPattern(i, j);
+    while (!handoff.ready()) std::this_thread::yield();
+    handoff.publish(frame, i);
+  }
+  consumer.join();
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = argc > 1 ? atoi(argv[1]) : 500;
+  if (argc > 2) sendTime = atoi(argv[2]);
+  uint32_t renderTime = argc > 3 ? atoi(argv[3]) : 2000;
+
+  uint32_t errors = checkHandoff(frames * 100);
+  printf("handoff: %u frames, %u torn, lost or repeated\n", frames * 100, errors);
+
+  BlockingOutput blocking;
+  Glowstick sequential(&blocking);
+  double sequentialTime = timeFrames(sequential, frames, renderTime);
+  printf("sequential: %.1f fps\n", frames / sequentialTime);
+
+  ThreadedOutput threaded;
+  Glowstick pipelined(&threaded);
+  double pipelinedTime = timeFrames(pipelined, frames, renderTime);
+  threaded.stop();
+  printf("pipelined: %.1f fps (%.2fx)\n", frames / pipelinedTime, sequentialTime / pipelinedTime);
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Replays a trace dumped from a device built with the trace env through the firmware on a host
+// Usage: replay <trace file>
+// Prints the recorded stage timings of each traced frame next to the time the host took,
+// the slowest display stage and unused stack the device recorded, then the trace recorded
+// during the replay, which should match the input trace's events
+
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+#include "../src/glowstick.hpp"
+
+struct ReplayEvent {
+  uint32_t time;
+  uint8_t type;
+  uint8_t data[3];
+};
+
+static Glowstick device;
+static uint32_t now = 0;
+
+// Only frames that might be interesting are traced, the ones in between ran every UpdateInterval
+// leading up to the next traced frame. Tick at those times so frames land where they did on the
+// device, input is only read by frames so nothing happens between them
+// Button events are recorded by the frame that read them, so they give its time too
+static void runFramesUntil(uint32_t time, uint32_t nextFrame) {
+  uint32_t frame = nextFrame < now ? now :
+                   nextFrame - (nextFrame - now) / UpdateInterval * UpdateInterval;
+  for (; frame < time; frame += UpdateInterval) {
+    hostSetMillis(frame);
+    device.tick();
+  }
+  now = max(now, time);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: replay <trace file>\n");
+    return 1;
+  }
+  FILE *file = fopen(argv[1], "r");
+  if (!file) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  // Read trace, extending the 16 bit timestamps
+  unsigned count, dropped, dumps;
+  if (fscanf(file, " trace %u %u %u", &count, &dropped, &dumps) != 3) {
+    fprintf(stderr, "%s: not a trace\n", argv[1]);
+    return 1;
+  }
+  // The replay starts from the state after init(), so it only matches a trace that does too
+  if (dumps) {
+    fprintf(stderr, "warning: trace continues %u earlier dumps, menus and settings will start "
+                    "from boot state and the replay may not match\n", dumps);
+  }
+  if (dropped) {
+    fprintf(stderr, "warning: %u events were dropped, replay may not match\n", dropped);
+  }
+  std::vector<ReplayEvent> events;
+  unsigned time, type, a, b, c;
+  uint16_t lastTime = 0;
+  uint32_t fullTime = 0;
+  while (fscanf(file, "%u %u %u %u %u", &time, &type, &a, &b, &c) == 5) {
+    fullTime += (uint16_t)(time - lastTime);
+    lastTime = time;
+    events.push_back({fullTime, (uint8_t)type, {(uint8_t)a, (uint8_t)b, (uint8_t)c}});
+  }
+  // Only dumps from a device have this
+  int stackUnused = -1;
+  if (fscanf(file, " stack %d", &stackUnused) != 1) stackUnused = -1;
+  fclose(file);
+
+  hostSetMillis(0);
+  device.init();
+  now = millis();
+
+  printf("time       device render/show/display us      host us\n");
+  uint32_t nextFrame = now;
+  uint32_t slowestDisplay = 0;
+  for (size_t i = 0; i < events.size(); i++) {
+    const ReplayEvent &event = events[i];
+    if (nextFrame < event.time) {
+      nextFrame = event.time;
+      for (size_t j = i; j < events.size(); j++) {
+        if (events[j].type != TraceEventEncoder) {
+          nextFrame = events[j].time;
+          break;
+        }
+      }
+    }
+    runFramesUntil(event.time, nextFrame);
+    hostSetMillis(event.time);
+    if (event.type == TraceEventEncoder) {
+      hostSetPin(PinEncoderB, (int8_t)event.data[0] > 0 ? LOW : HIGH);
+      hostTriggerInterrupt(PinEncoderA);
+    } else if (event.type == TraceEventButton) {
+      hostSetPin(PinEncoderButton, event.data[0] ? LOW : HIGH);
+      // Run the frame that read it unless it was traced too
+      if (i + 1 == events.size() || events[i + 1].type != TraceEventFrame ||
+          events[i + 1].time != event.time) {
+        device.tick();
+        now = event.time + 1;
+      }
+    } else if (event.type == TraceEventFrame) {
+      auto start = std::chrono::steady_clock::now();
+      device.tick();
+      auto end = std::chrono::steady_clock::now();
+      uint32_t deviceTime = 0;
+      for (uint8_t i = 0; i < 3; i++) deviceTime += event.data[i] * TraceTimeUnit;
+      slowestDisplay = max(slowestDisplay, (uint32_t)event.data[2] * TraceTimeUnit);
+      printf("%-10u %6u %6u %6u %12ld\n", event.time,
+             event.data[0] * TraceTimeUnit, event.data[1] * TraceTimeUnit,
+             event.data[2] * TraceTimeUnit,
+             (long)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+      // The device couldn't run again until the frame was done
+      now = max(now, event.time + deviceTime / 1000 + 1);
+    }
+  }
+  runFramesUntil(now + UpdateInterval, now + UpdateInterval);
+
+  // Display redraws and stack depth as measured on the device
+  printf("\ndevice: slowest traced display stage %u us", slowestDisplay);
+  if (stackUnused >= 0) printf(", stack never reached %d bytes of free RAM", stackUnused);
+  printf("\n");
+
+  printf("\nreplayed ");
+  fflush(stdout);
+  traceDump(Serial);
+  return 0;
+}
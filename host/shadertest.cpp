@@ -0,0 +1,87 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Checks the custom animation VM on the host: programs verifyShader() must turn away and the
+// results of a few known programs
+// Usage: shadertest, exits with 1 if anything fails
+
+#include <stdio.h>
+
+#include "../src/shadervm.hpp"
+
+static uint8_t failures = 0;
+
+static void expectInvalid(const char *name, const uint8_t *program, uint8_t length,
+                          uint16_t maxCycles = 0xFFFF) {
+  if (verifyShader(program, length, maxCycles)) {
+    printf("FAIL %s: accepted\n", name);
+    failures++;
+  }
+}
+
+static void expectResult(const char *name, const uint8_t *program, uint8_t length,
+                         uint8_t phase, uint8_t position, uint8_t source, uint8_t value) {
+  if (!verifyShader(program, length, 0xFFFF)) {
+    printf("FAIL %s: rejected\n", name);
+    failures++;
+    return;
+  }
+  ShaderResult result = runShader(program, phase, position);
+  if (result.source != source || result.value != value) {
+    printf("FAIL %s: got %u %u, expected %u %u\n", name, result.source, result.value,
+           source, value);
+    failures++;
+  }
+}
+
+int main() {
+  const uint8_t underflow[] = {ShaderOpPush, 1, ShaderOpAdd, ShaderOpColor};
+  expectInvalid("stack underflow", underflow, sizeof(underflow));
+  const uint8_t noOutput[] = {ShaderOpPush, 1, ShaderOpPhase, ShaderOpAdd};
+  expectInvalid("missing output", noOutput, sizeof(noOutput));
+  const uint8_t outputNotLast[] = {ShaderOpPhase, ShaderOpColor, ShaderOpPhase};
+  expectInvalid("output not last", outputNotLast, sizeof(outputNotLast));
+  const uint8_t noOperand[] = {ShaderOpPhase, ShaderOpColor, ShaderOpPush};
+  expectInvalid("missing operand", noOperand, sizeof(noOperand));
+  const uint8_t badOp[] = {ShaderOps, ShaderOpColor};
+  expectInvalid("unknown op", badOp, sizeof(badOp));
+  uint8_t overflow[ShaderStackSize + 2];
+  for (uint8_t i = 0; i <= ShaderStackSize; i++) overflow[i] = ShaderOpPhase;
+  overflow[ShaderStackSize + 1] = ShaderOpColor;
+  expectInvalid("stack overflow", overflow, sizeof(overflow));
+  expectInvalid("empty", underflow, 0);
+
+  // Longest program of the most expensive op, over the per pixel budget of 84 LEDs at 16MHz
+  uint8_t slow[ShaderMaxLength];
+  slow[0] = ShaderOpPhase;
+  for (uint8_t i = 1; i < ShaderMaxLength - 1; i++) slow[i] = ShaderOpSin8;
+  slow[ShaderMaxLength - 1] = ShaderOpColor;
+  expectInvalid("over budget", slow, sizeof(slow), 16000000UL / 1000 * 10 / 2 / 84);
+  if (!verifyShader(slow, sizeof(slow), 0xFFFF)) {
+    printf("FAIL over budget: rejected without a budget\n");
+    failures++;
+  }
+
+  const uint8_t constant[] = {ShaderOpPush, 100, ShaderOpColor};
+  expectResult("constant", constant, sizeof(constant), 0, 0, ShaderSourceColor, 100);
+  const uint8_t wrap[] = {ShaderOpPhase, ShaderOpPosition, ShaderOpAdd, ShaderOpPalette};
+  expectResult("wrapping add", wrap, sizeof(wrap), 200, 100, ShaderSourcePalette, 44);
+  const uint8_t saturate[] = {ShaderOpPush, 200, ShaderOpPush, 100, ShaderOpQAdd,
+                              ShaderOpPush, 50, ShaderOpQSub, ShaderOpColor};
+  expectResult("qadd/qsub", saturate, sizeof(saturate), 0, 0, ShaderSourceColor, 205);
+  const uint8_t swap[] = {ShaderOpPush, 1, ShaderOpPush, 3, ShaderOpSwap, ShaderOpQSub,
+                          ShaderOpColor};
+  expectResult("swap", swap, sizeof(swap), 0, 0, ShaderSourceColor, 2);
+  const uint8_t dup[] = {ShaderOpPosition, ShaderOpDup, ShaderOpAdd, ShaderOpColor};
+  expectResult("dup", dup, sizeof(dup), 0, 7, ShaderSourceColor, 14);
+  const uint8_t scale[] = {ShaderOpPush, 255, ShaderOpPush, 128, ShaderOpScale8,
+                           ShaderOpColor};
+  expectResult("scale8", scale, sizeof(scale), 0, 0, ShaderSourceColor, 128);
+  const uint8_t sine[] = {ShaderOpPhase, ShaderOpSin8, ShaderOpColor};
+  expectResult("sin8 0", sine, sizeof(sine), 0, 0, ShaderSourceColor, 128);
+  expectResult("sin8 64", sine, sizeof(sine), 64, 0, ShaderSourceColor, 255);
+  expectResult("sin8 192", sine, sizeof(sine), 192, 0, ShaderSourceColor, 1);
+
+  printf(failures ? "%u failed\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+// Runs one simulated glowstick in real time with stdin and stdout as the sync line
+// Usage: syncsim leader|follower|monitor [seconds]
+// Chain devices with pipes, for example:
+//   syncsim leader | syncsim follower | syncsim follower | syncsim monitor
+// Devices print their frame timing and estimated LED current to stderr when done, the monitor
+// checks the packets coming out of the end of the chain
+
+#include <chrono>
+#include <thread>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/glowstick.hpp"
+
+struct IntervalStats {
+  uint32_t count = 0;
+  uint32_t last = 0;
+  uint32_t min = UINT32_MAX;
+  uint32_t max = 0;
+  uint64_t total = 0;
+
+  void add(uint32_t time) {
+    if (count++ > 0) {
+      uint32_t interval = time - last;
+      if (interval < min) min = interval;
+      if (interval > max) max = interval;
+      total += interval;
+    }
+    last = time;
+  }
+
+  void print(const char *name) {
+    if (count < 2) {
+      fprintf(stderr, "%s: %u frames\n", name, count);
+      return;
+    }
+    fprintf(stderr, "%s: %u frames, interval min %.2f avg %.2f max %.2f ms\n", name, count,
+            min / 1000.0, total / 1000.0 / (count - 1), max / 1000.0);
+  }
+};
+
+static Glowstick device;
+
+// Steps the leader through the menus to the first animation
+static void pressButton() {
+  hostSetPin(PinEncoderButton, LOW);
+  for (uint32_t end = millis() + 50; millis() < end;) device.tick();
+  hostSetPin(PinEncoderButton, HIGH);
+  for (uint32_t end = millis() + 50; millis() < end;) device.tick();
+}
+
+static void runDevice(uint8_t mode, uint32_t seconds) {
+  EEPROM.put(EEPROMAddrSyncMode, mode);
+  device.init();
+
+  if (mode == SyncModeLeader) {
+    for (uint8_t i = 0; i < MenuItemAnimation; i++) {
+      hostSetPin(PinEncoderB, LOW);
+      hostTriggerInterrupt(PinEncoderA);
+      for (uint32_t end = millis() + 50; millis() < end;) device.tick();
+    }
+    pressButton();
+    pressButton();
+  }
+
+  IntervalStats frames;
+  uint16_t minCurrent = UINT16_MAX, maxCurrent = 0;
+  uint64_t totalCurrent = 0;
+  uint32_t lastFrame = FastLED.frames;
+  uint32_t end = millis() + seconds * 1000;
+  while (millis() < end) {
+    device.tick();
+    if (FastLED.frames != lastFrame) {
+      lastFrame = FastLED.frames;
+      frames.add(micros());
+      uint16_t current = device.getEstimatedCurrent();
+      if (current < minCurrent) minCurrent = current;
+      if (current > maxCurrent) maxCurrent = current;
+      totalCurrent += current;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  const char *name = mode == SyncModeLeader ? "leader" : "follower";
+  frames.print(name);
+  if (frames.count > 0) {
+    fprintf(stderr, "%s: current min %u avg %u max %u mA\n", name, minCurrent,
+            (unsigned)(totalCurrent / frames.count), maxCurrent);
+  }
+}
+
+// Reads packets from the end of the chain
+static void runMonitor(uint32_t seconds) {
+  IntervalStats packets;
+  uint32_t bad = 0;
+  uint32_t skipped = 0;
+  uint16_t offset = 0;
+  uint8_t animation = SyncNoAnimation;
+  uint8_t lastFrame = 0;
+
+  uint8_t buffer[sizeof(SyncPacket) + 3];
+  uint8_t length = 0;
+  bool escaped = false;
+  uint32_t end = millis() + seconds * 1000;
+  while (millis() < end) {
+    while (Serial.available() > 0) {
+      uint8_t data = Serial.read();
+      bool start = data == SerialFrameStart;
+      if (start) {
+        if (length > 0) bad++; // Unfinished packet
+        length = 0;
+        escaped = false;
+      } else if (data == SerialEscape) {
+        escaped = true;
+        continue;
+      } else if (escaped) {
+        data ^= SerialEscapeXor;
+        escaped = false;
+      }
+      if (length == 0 && !start) continue;
+      if (length == 1 && data != SerialCommandSync) {
+        length = 0;
+        continue;
+      }
+      buffer[length++] = data;
+      if (length < sizeof(buffer)) continue;
+      length = 0;
+
+      uint8_t checksum = 0;
+      for (uint8_t i = 2; i < sizeof(buffer) - 1; i++) checksum += buffer[i];
+      if (checksum != buffer[sizeof(buffer) - 1]) {
+        bad++;
+        continue;
+      }
+      SyncPacket packet;
+      memcpy(&packet, &buffer[2], sizeof(SyncPacket));
+      if (packets.count > 0 && packet.frame != (uint8_t)(lastFrame + 1)) skipped++;
+      lastFrame = packet.frame;
+      offset = packet.offset;
+      animation = packet.animation;
+      packets.add(micros());
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  packets.print("monitor");
+  fprintf(stderr, "monitor: %u bad, %u skipped, chain length %u LEDs, animation %u\n",
+          bad, skipped, offset, animation);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: syncsim leader|follower|monitor [seconds]\n");
+    return 1;
+  }
+  uint32_t seconds = argc == 3 ? atoi(argv[2]) : 5;
+  signal(SIGPIPE, SIG_IGN);
+  hostUseRealTime();
+  hostSerialFromStdin();
+
+  if (!strcmp(argv[1], "leader")) runDevice(SyncModeLeader, seconds);
+  else if (!strcmp(argv[1], "follower")) runDevice(SyncModeFollower, seconds);
+  else if (!strcmp(argv[1], "monitor")) runMonitor(seconds + 1);
+  else return 1;
+  return 0;
+}
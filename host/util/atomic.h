@@ -0,0 +1,8 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+// The simulated encoder interrupt runs on the same thread, so nothing needs to be done
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) for (bool atomicDone = false; !atomicDone; atomicDone = true)
@@ -19,10 +19,23 @@ const uint8_t LEDBrightnessRampSpeed = 10; // units/frame
 const RGBW LEDOff = RGBW(0, 0, 0, 0);
 const CRGB ColorCorrection = CRGB(255, 176, 240);
 
+// Power estimation
+const uint8_t LEDChannelCurrent[4] = {12, 12, 12, 18}; // mA per channel at full, GRBW order
+const uint8_t LEDIdleCurrent = 1; // mA per LED
+const uint8_t BaseCurrent = 30; // mA for the microcontroller and display
+const uint16_t PowerDefaultBudget = 2000; // mA
+const uint16_t PowerMinBudget = 200; // mA
+const uint16_t PowerMaxBudget = 10000; // mA
+const uint8_t PowerBudgetStep = 10; // mA per encoder step
+const uint8_t PowerLimitRecoverySpeed = 2; // units/frame
+const uint16_t LiveDisplayInterval = 250; // ms between updates of screens with live values
+
 // Display
 const uint8_t CharacterHeight = 8;
 const uint8_t LineHeight = 11;
 const uint8_t DisplayLines = 3;
+const uint8_t BackButtonWidth = 12;
+const uint8_t NumberBufferSize = 8; // 5 digits, decimal point, leading zero and terminator
 const uint16_t DisplayTimeout = 20000; // ms
 
 // Encoder / button
@@ -32,9 +45,46 @@ const uint8_t EncoderFineAdjustScale = 1; // minimum adjustment speed
 const uint8_t EncoderCoarseAdjustScale = 12; // maximum adjustment speed
 const float EncoderScaleFloat = 0.025; // fine scale for floating-point number inputs
 
+// Animations
+const uint8_t AnimationParamCount = 3; // speed, scale, shape
+const uint8_t AnimationSoftEdgeSlope = 2; // edge steepness of smooth triangles
+const uint8_t NoiseGradientStops = 8; // gradient colors converted per frame for noise animations
+const uint8_t NoiseLavaContrast = 3;
+const uint8_t NoiseShimmerFloor = 48; // minimum brightness of shimmer
+const uint8_t NoiseMaxLEDs = 144; // strip length noise animations have to fit the budget for
+
+// Calibration
+// Each segment of LEDs gets its own gain per channel to even out differences between strips
+const uint8_t CalibrationSegmentLength = 6; // 1 for per LED gains (uses 4 bytes of RAM per LED)
+const uint8_t CalibrationSegments = (LEDCount + CalibrationSegmentLength - 1) /
+                                    CalibrationSegmentLength;
+
 // Misc
 const uint8_t UpdateInterval = 10; // ms per frame
 
+// Serial
+const uint32_t SerialBaudRate = 115200;
+const uint16_t SerialTimeout = 500; // ms, drops a partially received command
+const uint8_t SerialFrameStart = '#'; // sent before each command below, never inside one
+// Payload bytes equal to SerialFrameStart or SerialEscape are sent as SerialEscape, byte ^ 0x20
+const uint8_t SerialEscape = '}';
+const uint8_t SerialEscapeXor = 0x20;
+const uint8_t SerialCommandShader = 'S'; // followed by length, program, checksum
+const uint8_t SerialCommandTrace = 'T'; // dump and clear the trace (trace builds only)
+const uint8_t SerialCommandSync = 'Y'; // followed by SyncPacket, checksum
+const uint8_t SerialCommandCalibration = 'C'; // followed by segment, 4 gains (GRBW), checksum
+const uint8_t SerialCommandBenchmark = 'B'; // time noise animations (trace builds only)
+
+// Multi-stick sync
+const uint8_t SyncSlack = 3; // ms a follower waits past its own frame time for a late packet
+const uint8_t SyncTimeout = 100; // ms without packets before a follower runs on its own
+const uint8_t SyncNoAnimation = 255; // sent when the leader isn't showing an animation
+
+// Custom and noise animations
+// Rendering gets about half of each frame, the rest goes to FastLED.show() and the UI
+// Custom animations are timed on the device when they're loaded, in the slowest color mode
+const uint32_t ShaderCycleBudget = F_CPU / 1000 * UpdateInterval / 2;
+
 // EEPROM Settings
 const uint8_t EEPROMAddrInitialization = 0;
 const uint8_t EEPROMAddrDisplayBrightness = 1;
@@ -42,4 +92,16 @@ const uint8_t EEPROMAddrHSVValue = 2;
 const uint8_t EEPROMAddrWhiteValue = 5; // 3 bytes for hsv
 const uint8_t EEPROMAddrGradient0 = 6;
 const uint8_t EEPROMAddrGradient1 = 9;
+const uint8_t EEPROMAddrSceneFadeTime = 12;
+const uint8_t EEPROMAddrPowerBudget = 13; // 2 bytes
+const uint8_t EEPROMAddrSyncMode = 15;
+const uint8_t EEPROMAddrScenes = 16; // SceneSlots * sizeof(Scene) bytes
+const uint8_t EEPROMAddrShader = 96; // length followed by ShaderMaxLength bytes
+const uint16_t EEPROMAddrCalibration = 129; // CalibrationSegments * 4 bytes, 255 if never written
+
+// Scenes
+const uint8_t SceneSlots = 4;
+const uint8_t SceneDefaultFadeTime = 10; // 100ms units
+const uint8_t SceneMaxFadeTime = 100; // 100ms units
+const uint16_t SceneParamScale = 1000; // animation params are stored as fixed point
 
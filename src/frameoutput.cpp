@@ -0,0 +1,20 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "constants.hpp"
+#include "frameoutput.hpp"
+
+FastLEDFrameOutput fastLEDOutput;
+
+void FastLEDFrameOutput::begin(RGBW *frame, uint16_t count) {
+  CRGB *ledsRGB = (CRGB *) frame; // Hack to get RGBW to work
+  FastLED.addLeds<WS2812B, PinLEDs>(ledsRGB, getRGBWSize(count));
+}
+
+void FastLEDFrameOutput::show(uint8_t brightness) {
+  FastLED.setBrightness(brightness);
+  FastLED.show();
+}
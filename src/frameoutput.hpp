@@ -0,0 +1,72 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "fastledrgbw.hpp"
+
+// Output stage of the LED pipeline
+// Glowstick::tick() renders into its frame buffer, post-processes (brightness ramp, power limit)
+// and then hands the frame to an output, which is free to send it while the next frame is drawn
+class FrameOutput {
+  public:
+    // Called once with the render buffer
+    virtual void begin(RGBW *frame, uint16_t count) = 0;
+    // Sends the render buffer at the given brightness, returns once the next frame can be drawn
+    virtual void show(uint8_t brightness) = 0;
+};
+
+// Sends the render buffer directly with FastLED
+// Used on the ATmega328: show() blocks with interrupts disabled, so there is nothing to overlap
+// with and a second pair of frame buffers (2 * LEDCount * 4 bytes) wouldn't fit next to the display
+class FastLEDFrameOutput : public FrameOutput {
+  public:
+    void begin(RGBW *frame, uint16_t count);
+    void show(uint8_t brightness);
+};
+
+extern FastLEDFrameOutput fastLEDOutput;
+
+#ifndef __AVR__
+#include <atomic>
+
+// Lock free handoff of finished frames from the render side to an output on another thread/core
+// The render side copies its frame into the back buffer, the output side sends the front buffer
+// Only one thread may publish and only one thread may take
+template<uint16_t Count>
+class FrameHandoff {
+  public:
+    // True once the output side has taken the last published frame, which also means it has
+    // finished sending the one before, so the back buffer is free
+    bool ready() {
+      return pending.load(std::memory_order_acquire) < 0;
+    }
+
+    // Copy a frame into the back buffer and make it available to take(), only call when ready()
+    void publish(const RGBW *frame, uint8_t brightness) {
+      memcpy(frames[back], frame, sizeof(frames[back]));
+      brightnesses[back] = brightness;
+      pending.store(back, std::memory_order_release);
+      back ^= 1;
+    }
+
+    // Returns the newest frame or nullptr if there isn't one
+    // The frame stays valid until the next call to take()
+    const RGBW *take(uint8_t &brightness) {
+      int8_t index = pending.load(std::memory_order_acquire);
+      if (index < 0) return nullptr;
+      brightness = brightnesses[index];
+      pending.store(-1, std::memory_order_release);
+      return frames[index];
+    }
+
+  private:
+    RGBW frames[2][Count];
+    uint8_t brightnesses[2];
+    uint8_t back = 0;
+    std::atomic<int8_t> pending{-1}; // index of the published frame, -1 if it was taken
+};
+#endif
@@ -22,6 +22,7 @@ static void encoderISR() {
     encoderScale = constrain(encoderScale, EncoderFineAdjustScale, EncoderCoarseAdjustScale);
 
     lastEncoderRead = time;
+    traceEvent(time, TraceEventEncoder, b ? 1 : -1, encoderScale);
   }
 }
 
@@ -37,11 +38,57 @@ static float wrap(float in, float min, float max) {
   else return min + (in - max);
 }
 
+// Move a value towards a target by a 0.16 fixed-point fraction of the distance
+// Stochastic rounding keeps long fades from stalling on small differences, dither is a random
+// number drawn once per pixel and shared by its channels
+static uint8_t crossfade8(uint8_t from, uint8_t to, uint16_t amount, uint16_t dither) {
+  uint8_t distance = from < to ? to - from : from - to;
+  uint8_t step = ((uint32_t)distance * amount + dither) >> 16;
+  return from < to ? from + step : from - step;
+}
+
+// Sends a command payload byte, escaping the bytes used for framing
+static void writeEscaped(uint8_t data) {
+  if (data == SerialFrameStart || data == SerialEscape) {
+    Serial.write(SerialEscape);
+    data ^= SerialEscapeXor;
+  }
+  Serial.write(data);
+}
+
+// Current drawn by one LED at full brightness, in mA * 255
+static uint16_t ledCurrent(RGBW color) {
+  uint16_t load = 0;
+  for (uint8_t c = 0; c < 4; c++) load += (uint16_t)color.raw[c] * LEDChannelCurrent[c];
+  return load;
+}
+
+static RGBW blendRGBW(RGBW start, RGBW end, fract8 amount) {
+  return RGBW(lerp8by8(start.r, end.r, amount), lerp8by8(start.g, end.g, amount),
+              lerp8by8(start.b, end.b, amount), lerp8by8(start.w, end.w, amount));
+}
+
+static RGBW scaleRGBW(RGBW color, uint8_t scale) {
+  return RGBW(scale8(color.r, scale), scale8(color.g, scale),
+              scale8(color.b, scale), scale8(color.w, scale));
+}
+
+// Blend between two colors along the hue wheel the same way as drawGradient
+static HSV blendHSV(HSV start, HSV end, fract8 amount) {
+  int16_t startHue = start.h > end.h ? start.h - 256 : start.h;
+  return HSV(startHue + ((int32_t)(end.h - startHue) * amount >> 8),
+             lerp8by8(start.s, end.s, amount), lerp8by8(start.v, end.v, amount));
+}
+
 Glowstick::Glowstick() {
 }
 
+Glowstick::Glowstick(FrameOutput *output) : output(output) {
+}
+
 // Initializes everything
 void Glowstick::init() {
+  traceStackPaint();
   pinMode(PinLEDs, OUTPUT);
   pinMode(PinEncoderA, INPUT_PULLUP);
   pinMode(PinEncoderB, INPUT_PULLUP);
@@ -59,20 +106,28 @@ void Glowstick::init() {
     EEPROM.get(EEPROMAddrDisplayBrightness, displayBrightness);
     EEPROM.get(EEPROMAddrGradient0, gradientColors[0]);
     EEPROM.get(EEPROMAddrGradient1, gradientColors[1]);
+    EEPROM.get(EEPROMAddrSceneFadeTime, sceneFadeTime);
+    if (sceneFadeTime > SceneMaxFadeTime) sceneFadeTime = SceneDefaultFadeTime; // Never written
+    EEPROM.get(EEPROMAddrPowerBudget, powerBudget);
+    if (powerBudget < PowerMinBudget || powerBudget > PowerMaxBudget) {
+      powerBudget = PowerDefaultBudget; // Never written
+    }
+    EEPROM.get(EEPROMAddrSyncMode, syncMode);
+    if (syncMode >= SyncModes) syncMode = SyncModeOff;
   }
+  loadCalibration();
+  loadShader();
 
   cli(); // Disable interrupts before attaching and then enable
   // Having the interrupt on RISING/FALLING breaks everything for some reason (cheap encoders?)
   attachInterrupt(digitalPinToInterrupt(PinEncoderA), encoderISR, LOW);
   sei();
 
-  //Serial.begin(115200);
+  Serial.begin(SerialBaudRate);
 
-  CRGB *ledsRGB = (CRGB *) &leds[0]; // Hack to get RGBW to work
-  FastLED.addLeds<WS2812B, PinLEDs>(ledsRGB, getRGBWSize(LEDCount));
-  FastLED.setBrightness(LEDMasterBrightness);
+  output->begin(leds, LEDCount);
   setAllLEDs(LEDOff);
-  FastLED.show();
+  output->show(LEDMasterBrightness);
 
   u8g2.begin();
   u8g2.setFontMode(1);
@@ -86,9 +141,9 @@ void Glowstick::init() {
 
   // Display startup screen
   u8g2.setFont(u8g2_font_logisoso16_tr);
-  u8g2.drawStr(0, 16, "GlowStick");
+  drawLabel(0, 16, F("GlowStick"));
   u8g2.setFont(u8g2_font_profont12_tr);
-  u8g2.drawStr(0, 30, "FW v1.0 by jackw01 <3");
+  drawLabel(0, 30, F("FW v1.0 by jackw01 <3"));
   u8g2.sendBuffer();
 
   delay(800);
@@ -96,87 +151,242 @@ void Glowstick::init() {
 
 // Update function, called in a loop
 void Glowstick::tick() {
+  // Serial is read on every call, the RX buffer would overflow at the frame rate
+  handleSerial();
+
   // Rate limit the loop
+  // Followers draw as soon as a packet arrives and only use their own timer if one is late
   uint32_t time = millis();
-  if (time - lastUpdate >= UpdateInterval) {
-    //Serial.println(time - lastUpdate);
-    // Read encoder and button
-    if (encoderDelta != 0) {
-      handleEncoderChange();
-      encoderDelta = 0;
-    }
+  bool following = syncMode == SyncModeFollower && syncAnimating &&
+                   time - lastSyncPacket < SyncTimeout;
+  if (syncFrameReady ||
+      time - lastUpdate >= (following ? UpdateInterval + SyncSlack : UpdateInterval)) {
+    uint32_t frameStart = micros();
 
-    bool buttonState = !digitalRead(PinEncoderButton);
-    if (buttonState != prevButtonState) {
-      if (time - lastButtonChange > DebounceInterval && buttonState) handleButtonPress();
-      lastButtonChange = time;
-    }
-    prevButtonState = buttonState;
-
-    // Update LEDs
-    if (displayState == DisplayStateHSV) {
-      setAllLEDs(hsv2rgbw(hsvValue, ColorCorrection));
-    } else if (displayState == DisplayStateWhite) {
-      setAllLEDs(RGBW(0, 0, 0, whiteValue));
-    } else if (displayState == DisplayStateGradient) {
-      drawGradient(0, LEDCount, gradientColors[0], gradientColors[1]);
-    } else if (displayState == DisplayStateAnimation) {
-      drawAnimationFrame(time);
-    }
+    handleInput(time);
+    renderFrame(time, following);
+    uint8_t brightness = postProcessFrame(following);
+    uint32_t showStart = micros();
+    output->show(brightness);
 
-    // Ramp brightness up/down
-    if (displayState == DisplayStateMenu ||
-        displayState == DisplayStateAnimationMenu ||
-        displayState == DisplayStateBrightness) {
-      ledTransitionState = max(ledTransitionState - LEDBrightnessRampSpeed, 0);
-    } else {
-      ledTransitionState = min(ledTransitionState + LEDBrightnessRampSpeed, 255);
+    // Leader sends right after show so followers draw their frame at the same time
+    // Not while a command is coming in, so the host only gets the reply between packets
+    if (syncMode == SyncModeLeader && !serialCommand) {
+      SyncPacket packet;
+      packet.frame = ++syncFrame;
+      packet.phase = animationPhase >> 8;
+      packet.animation = ledMode == DisplayStateAnimation ? currentAnimation : SyncNoAnimation;
+      packet.brightness = ledTransitionState;
+      for (uint8_t i = 0; i < AnimationParamCount; i++) {
+        packet.animationParams[i] = animationParams[i] * SceneParamScale;
+      }
+      packet.offset = LEDCount;
+      sendSyncPacket(packet);
     }
-    FastLED.setBrightness(LEDMasterBrightness * ledTransitionState / 255);
-    FastLED.show();
 
     // Redraw display
+    uint32_t displayStart = micros();
+    if ((displayState == DisplayStatePower || displayState == DisplayStateSync) &&
+        time - lastDisplayUpdate > LiveDisplayInterval) {
+      displayNeedsRedrawing = true;
+    }
+    bool redrawing = displayNeedsRedrawing;
     if (displayNeedsRedrawing) {
-      u8g2.clearBuffer();
-      if (displayState == DisplayStateMenu) drawScrollingMenu(MainMenuStrings);
-      else if (displayState == DisplayStateHSV) drawHSVControls();
-      else if (displayState == DisplayStateWhite) drawWhiteControls();
-      else if (displayState == DisplayStateGradient) drawGradientControls();
-      else if (displayState == DisplayStateAnimationMenu) drawScrollingMenu(AnimationMenuStrings);
-      else if (displayState == DisplayStateBrightness) drawBrightnessControls();
-      else if (displayState == DisplayStateAnimation) drawAnimationControls();
-      u8g2.sendBuffer();
+      redrawDisplay();
       displayNeedsRedrawing = false;
       lastDisplayUpdate = time;
     } else if (time - lastDisplayUpdate > DisplayTimeout) {
       u8g2.clear();
+      labelledScreen = 255;
+    }
+
+    // Only frames that might be interesting are traced to save space
+    uint32_t frameEnd = micros();
+    if (redrawing || time - lastUpdate > UpdateInterval ||
+        frameEnd - frameStart > UpdateInterval * 1000UL) {
+      traceEvent(time, TraceEventFrame, traceDuration(showStart - frameStart),
+                 traceDuration(displayStart - showStart), traceDuration(frameEnd - displayStart));
     }
 
     lastUpdate = time;
   }
 }
 
+// Frame stages, run in order by tick()
+
+// Read encoder and button
+void Glowstick::handleInput(uint32_t time) {
+  if (encoderDelta != 0) {
+    handleEncoderChange();
+    encoderDelta = 0;
+  }
+
+  bool buttonState = !digitalRead(PinEncoderButton);
+  if (buttonState != prevButtonState) {
+    traceEvent(time, TraceEventButton, buttonState);
+    if (time - lastButtonChange > DebounceInterval && buttonState) handleButtonPress();
+    lastButtonChange = time;
+  }
+  prevButtonState = buttonState;
+}
+
+// Draw the next frame into leds
+void Glowstick::renderFrame(uint32_t time, bool following) {
+  // The scene and power screens keep showing whatever was last drawn
+  if (displayState <= DisplayStateGradient || displayState == DisplayStateAnimation) {
+    ledMode = displayState;
+  }
+  uint8_t ledState = displayState == DisplayStateScenes || displayState == DisplayStatePower ||
+                     displayState == DisplayStateSync ? ledMode : displayState;
+  if (following) ledState = DisplayStateAnimation;
+
+  // Followers get their phase from the leader, otherwise advance it by the time since last frame
+  // (8.24 fixed point cycles, 16777.216 = 2^24 / 1000ms)
+  if (!syncFrameReady) {
+    animationPhase += (uint32_t)((time - lastUpdate) * animationParams[0] * 16777.216);
+  }
+  syncFrameReady = false;
+
+  // Crossfade in place: each frame covers 1/n of the remaining distance to the new frame,
+  // which is a linear fade for static scenes and needs no second frame buffer
+  crossfadeAmount = crossfadeFrames > 1 ? 65536UL / crossfadeFrames : 0;
+  if (crossfadeFrames > 0) crossfadeFrames--;
+
+  if (ledState == DisplayStateHSV) {
+    setAllLEDs(hsv2rgbw(hsvValue, ColorCorrection));
+  } else if (ledState == DisplayStateWhite) {
+    setAllLEDs(RGBW(0, 0, 0, whiteValue));
+  } else if (ledState == DisplayStateGradient) {
+    drawGradient(0, LEDCount, gradientColors[0], gradientColors[1]);
+  } else if (ledState == DisplayStateAnimation) {
+    drawAnimationFrame(animationPhase >> 8);
+  }
+}
+
+// Ramp brightness up/down and apply the power limit, returns the brightness to show the frame at
+uint8_t Glowstick::postProcessFrame(bool following) {
+  if (following) {
+    ledTransitionState = syncBrightness;
+  } else if (displayState == DisplayStateMenu ||
+      displayState == DisplayStateAnimationMenu ||
+      displayState == DisplayStateBrightness) {
+    ledTransitionState = max(ledTransitionState - LEDBrightnessRampSpeed, 0);
+  } else {
+    ledTransitionState = min(ledTransitionState + LEDBrightnessRampSpeed, 255);
+  }
+  return limitBrightness(LEDMasterBrightness * ledTransitionState / 255);
+}
+
 // Drawing utils
 
+// Labels stay in the frame buffer while a screen is shown, so after the first redraw only the back
+// button and the part with values are cleared, drawn and sent to the display
+void Glowstick::redrawDisplay() {
+  uint8_t left = ScreenValueLeft[displayState];
+  uint8_t top = ScreenValueTop[displayState];
+  bool full = displayState != labelledScreen;
+  if (full) {
+    u8g2.clearBuffer();
+    drawLabels();
+    labelledScreen = displayState;
+  } else {
+    u8g2.setDrawColor(0);
+    u8g2.drawBox(0, 0, BackButtonWidth, u8g2.getDisplayHeight());
+    u8g2.drawBox(left, top, u8g2.getDisplayWidth() - left, u8g2.getDisplayHeight() - top);
+    u8g2.setDrawColor(1);
+  }
+
+  if (displayState == DisplayStateMenu) drawScrollingMenu(MainMenuStrings);
+  else if (displayState == DisplayStateHSV) drawHSVControls();
+  else if (displayState == DisplayStateWhite) drawWhiteControls();
+  else if (displayState == DisplayStateGradient) drawGradientControls();
+  else if (displayState == DisplayStateAnimationMenu) drawScrollingMenu(AnimationMenuStrings);
+  else if (displayState == DisplayStateBrightness) drawBrightnessControls();
+  else if (displayState == DisplayStateAnimation) drawAnimationControls();
+  else if (displayState == DisplayStateScenes) drawSceneControls();
+  else if (displayState == DisplayStatePower) drawPowerControls();
+  else if (displayState == DisplayStateSync) drawSyncControls();
+
+  // Tiles are 8x8 pixels
+  uint8_t backTiles = (BackButtonWidth + 7) / 8;
+  if (full || left / 8 < backTiles) {
+    u8g2.sendBuffer();
+  } else {
+    sendDisplayTiles(0, 0, backTiles, u8g2.getBufferTileHeight());
+    sendDisplayTiles(left / 8, top / 8, u8g2.getBufferTileWidth() - left / 8,
+                     u8g2.getBufferTileHeight() - top / 8);
+  }
+}
+
+// Sends an area of the screen in 8x8 pixel tiles
+// updateDisplayArea() takes buffer tiles, which are rotated 180 degrees from the screen by U8G2_R2
+void Glowstick::sendDisplayTiles(uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+  u8g2.updateDisplayArea(u8g2.getBufferTileWidth() - x - w, u8g2.getBufferTileHeight() - y - h,
+                         w, h);
+}
+
+// Parts of screens that don't change while they're shown, see ScreenValueLeft/ScreenValueTop
+void Glowstick::drawLabels() {
+  if (displayState == DisplayStateHSV || displayState == DisplayStateGradient) {
+    drawLabel(16, CharacterHeight, F("H"));
+    drawLabel(16, CharacterHeight + LineHeight, F("S"));
+    drawLabel(16, CharacterHeight + 2 * LineHeight, F("V"));
+  } else if (displayState == DisplayStateWhite) {
+    drawLabel(16, CharacterHeight, F("White Brightness"));
+  } else if (displayState == DisplayStateAnimation) {
+    drawLabel(16, CharacterHeight, F("Speed"));
+    drawLabel(16, CharacterHeight + LineHeight, F("Scale"));
+    drawLabel(16, CharacterHeight + 2 * LineHeight, F("Shape"));
+  } else if (displayState == DisplayStatePower) {
+    drawLabel(16, CharacterHeight, F("Power"));
+    drawLabel(16, CharacterHeight + LineHeight, F("Now"));
+    drawLabel(16, CharacterHeight + 2 * LineHeight, F("Budget"));
+  } else if (displayState == DisplayStateBrightness) {
+    drawLabel(16, CharacterHeight, F("Display Brightness"));
+  }
+}
+
+// Draws a string straight from PROGMEM, glyph by glyph
+void Glowstick::drawLabel(uint8_t x, uint8_t y, const __FlashStringHelper *label) {
+  u8g2.setCursor(x, y);
+  u8g2.print(label);
+}
+
+// Draws value / 10^decimals followed by an optional unit
+// Print needs a 33 byte buffer for integers and the float library for decimals
+void Glowstick::drawNumber(uint8_t x, uint8_t y, uint16_t value, uint8_t decimals,
+                           const __FlashStringHelper *unit) {
+  char buffer[NumberBufferSize];
+  char *c = buffer + NumberBufferSize - 1;
+  *c = 0;
+  uint8_t digits = 0;
+  do {
+    *--c = '0' + value % 10;
+    value /= 10;
+    if (++digits == decimals) *--c = '.';
+  } while (value || digits <= decimals);
+  x += u8g2.drawStr(x, y, c);
+  if (unit) drawLabel(x, y, unit);
+}
+
 void Glowstick::drawScrollingMenu(const char * const *strings) {
   uint8_t lastItem = scrollOffset + DisplayLines - 1;
   if (currentMenuItem >= lastItem) scrollOffset += currentMenuItem - lastItem;
   if (currentMenuItem < scrollOffset) scrollOffset = currentMenuItem;
 
-  char buffer[MenuStringBufferSize];
   for (uint8_t i = 0; i < currentMenuLength - scrollOffset; i++) {
     if (i + scrollOffset == currentMenuItem) {
       u8g2.drawTriangle(0, i * LineHeight,
                         8, i * LineHeight + CharacterHeight / 2,
                         0, i * LineHeight + CharacterHeight);
     }
-    strcpy_P(buffer, (char *)pgm_read_word(&(strings[i + scrollOffset])));
-    u8g2.drawStr(10, CharacterHeight + i * LineHeight, buffer);
+    drawLabel(10, CharacterHeight + i * LineHeight,
+              (const __FlashStringHelper *)pgm_read_word(&(strings[i + scrollOffset])));
   }
 }
 
 void Glowstick::drawBackButton(bool highlight) {
-  if (highlight) u8g2.drawBox(0, 0, 12, u8g2.getDisplayHeight());
+  if (highlight) u8g2.drawBox(0, 0, BackButtonWidth, u8g2.getDisplayHeight());
   u8g2.setDrawColor(2);
   u8g2.drawTriangle(10, LineHeight,
                     2, LineHeight + CharacterHeight / 2,
@@ -210,25 +420,16 @@ void Glowstick::drawHSVControls() {
   for (uint8_t i = HSVMenuItemH; i <= HSVMenuItemV; i++) {
     drawSlider(i, 25, u8g2.getDisplayWidth() - 25 - 20, hsvValue[i], 0, 255,
                currentMenuItem == i, currentMenuItem == i && editState);
-    u8g2.setCursor(u8g2.getDisplayWidth() - 18, CharacterHeight + i * LineHeight);
-    if (i == 0) u8g2.print(map(hsvValue[i], 0, 255, 0, 359));
-    else u8g2.print(map(hsvValue[i], 0, 255, 0, 100));
+    drawNumber(u8g2.getDisplayWidth() - 18, CharacterHeight + i * LineHeight,
+               map(hsvValue[i], 0, 255, 0, i == 0 ? 359 : 100));
   }
-
-  // Labels
-  u8g2.drawStr(16, CharacterHeight, "H");
-  u8g2.drawStr(16, CharacterHeight + LineHeight, "S");
-  u8g2.drawStr(16, CharacterHeight + 2 * LineHeight, "V");
 }
 
 void Glowstick::drawWhiteControls() {
   drawBackButton(currentMenuItem == WhiteMenuItemBack);
-  u8g2.drawStr(16, CharacterHeight, "White Brightness");
   drawSlider(1, 16, u8g2.getDisplayWidth() - 16, whiteValue, 0, 255,
              currentMenuItem == WhiteMenuItemBrightness, editState);
-  u8g2.setCursor(16, CharacterHeight + 2 * LineHeight);
-  u8g2.print(map(whiteValue, 0, 255, 0, 100));
-  u8g2.print("%");
+  drawNumber(16, CharacterHeight + 2 * LineHeight, map(whiteValue, 0, 255, 0, 100), 0, F("%"));
 }
 
 void Glowstick::drawGradientControls() {
@@ -243,35 +444,102 @@ void Glowstick::drawGradientControls() {
                gradientColors[color][value], 0, 255,
                currentMenuItem == i, currentMenuItem == i && editState);
   }
-
-  // Labels
-  u8g2.drawStr(16, CharacterHeight, "H");
-  u8g2.drawStr(16, CharacterHeight + LineHeight, "S");
-  u8g2.drawStr(16, CharacterHeight + 2 * LineHeight, "V");
 }
 
 void Glowstick::drawAnimationControls() {
   drawBackButton(currentMenuItem == AnimationControlMenuItemBack);
-  u8g2.drawStr(16, CharacterHeight, "Animation");
 
-  // Sliders
-  for (uint8_t i = 0; i <= 1; i++) {
-    drawSlider(i + 1, 48, u8g2.getDisplayWidth() - 48,
+  // Sliders, speed is shorter to make room for the frequency
+  for (uint8_t i = 0; i < AnimationParamCount; i++) {
+    drawSlider(i, 48, u8g2.getDisplayWidth() - (i == 0 ? 90 : 48),
                mapFloat(animationParams[i], 0.0, 10.0, 0.0, 255.0), 0, 255,
                currentMenuItem == i, currentMenuItem == i && editState);
   }
 
-  // Labels
-  u8g2.drawStr(16, CharacterHeight + LineHeight, "Speed");
-  u8g2.drawStr(16, CharacterHeight + 2 * LineHeight, "Scale");
-  u8g2.setCursor(u8g2.getDisplayWidth() - 40, CharacterHeight);
-  u8g2.print(animationParams[0], 3);
-  u8g2.print("Hz");
+  drawNumber(u8g2.getDisplayWidth() - 40, CharacterHeight,
+             animationParams[0] * 1000 + 0.5, 3, F("Hz"));
+}
+
+void Glowstick::drawSceneControls() {
+  drawBackButton(currentMenuItem == SceneMenuItemBack);
+
+  // Values
+  drawLabel(16, CharacterHeight, F("Scene"));
+  drawNumber(52, CharacterHeight, sceneSlot + 1);
+  drawLabel(72, CharacterHeight, F("Fade"));
+  drawNumber(100, CharacterHeight, sceneFadeTime, 1, F("s"));
+
+  // Actions
+  drawLabel(16, CharacterHeight + LineHeight, F("Recall"));
+  if (sceneSlotEmpty) drawLabel(72, CharacterHeight + LineHeight, F("Empty"));
+  drawLabel(16, CharacterHeight + 2 * LineHeight, F("Save"));
+
+  // Highlight selected item, invert it while editing
+  const uint8_t left[] = {48, 96, 14, 14};
+  const uint8_t width[] = {16, 32, 40, 40};
+  const uint8_t line[] = {0, 0, 1, 2};
+  if (currentMenuItem < SceneMenuItemBack) {
+    uint8_t i = currentMenuItem;
+    if (editState || i >= SceneMenuItemRecall) {
+      u8g2.setDrawColor(2);
+      u8g2.drawBox(left[i], line[i] * LineHeight, width[i], LineHeight - 1);
+      u8g2.setDrawColor(1);
+    } else {
+      u8g2.drawFrame(left[i], line[i] * LineHeight, width[i], LineHeight - 1);
+    }
+  }
+}
+
+void Glowstick::drawPowerControls() {
+  drawBackButton(currentMenuItem == PowerMenuItemBack);
+  if (powerLimit < 255) {
+    drawLabel(64, CharacterHeight, F("Limit"));
+    drawNumber(u8g2.getDisplayWidth() - 24, CharacterHeight, map(powerLimit, 0, 255, 0, 100), 0,
+               F("%"));
+  }
+  drawNumber(64, CharacterHeight + LineHeight, estimatedCurrent, 0, F("mA"));
+  drawNumber(64, CharacterHeight + 2 * LineHeight, powerBudget, 0, F("mA"));
+  if (currentMenuItem == PowerMenuItemBudget) {
+    if (editState) {
+      u8g2.setDrawColor(2);
+      u8g2.drawBox(62, 2 * LineHeight, u8g2.getDisplayWidth() - 62, LineHeight - 1);
+      u8g2.setDrawColor(1);
+    } else {
+      u8g2.drawFrame(62, 2 * LineHeight, u8g2.getDisplayWidth() - 62, LineHeight - 1);
+    }
+  }
+}
+
+void Glowstick::drawSyncControls() {
+  drawBackButton(currentMenuItem == SyncMenuItemBack);
+  drawLabel(16, CharacterHeight, F("Sync"));
+  drawLabel(64, CharacterHeight,
+            (const __FlashStringHelper *)pgm_read_word(&(SyncModeStrings[syncMode])));
+  if (currentMenuItem == SyncMenuItemMode) {
+    if (editState) {
+      u8g2.setDrawColor(2);
+      u8g2.drawBox(62, 0, u8g2.getDisplayWidth() - 62, LineHeight - 1);
+      u8g2.setDrawColor(1);
+    } else {
+      u8g2.drawFrame(62, 0, u8g2.getDisplayWidth() - 62, LineHeight - 1);
+    }
+  }
+
+  if (syncMode == SyncModeFollower) {
+    bool locked = millis() - lastSyncPacket < SyncTimeout;
+    drawLabel(16, CharacterHeight + LineHeight, locked ? F("Locked") : F("No signal"));
+    if (locked) {
+      drawLabel(16, CharacterHeight + 2 * LineHeight, F("Offset"));
+      drawNumber(64, CharacterHeight + 2 * LineHeight, stripOffset);
+    }
+  } else if (syncMode == SyncModeLeader) {
+    drawLabel(16, CharacterHeight + LineHeight, F("Frame"));
+    drawNumber(64, CharacterHeight + LineHeight, syncFrame);
+  }
 }
 
 void Glowstick::drawBrightnessControls() {
   drawBackButton(true);
-  u8g2.drawStr(16, CharacterHeight, "Display Brightness");
   drawSlider(1, 16, u8g2.getDisplayWidth() - 16, displayBrightness, 0, 255,
              true, true);
 }
@@ -294,6 +562,26 @@ void Glowstick::handleEncoderChange() {
     animationParams[currentMenuItem] = wrap(animationParams[currentMenuItem] +
                                             encoderDelta * encoderScale * EncoderScaleFloat,
                                             0.0, 10.0);
+  } else if (displayState == DisplayStateScenes && editState) { // Select slot or fade time
+    if (currentMenuItem == SceneMenuItemSlot) {
+      int8_t slot = sceneSlot + encoderDelta % SceneSlots;
+      if (slot < 0) slot += SceneSlots;
+      else if (slot >= SceneSlots) slot -= SceneSlots;
+      sceneSlot = slot;
+      sceneSlotEmpty = false;
+    } else {
+      sceneFadeTime = constrain(sceneFadeTime + encoderDelta * encoderScale, 0, SceneMaxFadeTime);
+    }
+  } else if (displayState == DisplayStatePower && editState) { // Adjust power budget
+    // Clamped rather than wrapped so the budget can't jump from minimum to maximum
+    int32_t budget = powerBudget + (int32_t)encoderDelta * encoderScale * PowerBudgetStep;
+    powerBudget = constrain(budget, PowerMinBudget, PowerMaxBudget);
+  } else if (displayState == DisplayStateSync && editState) { // Change sync role
+    int8_t mode = syncMode + encoderDelta % SyncModes;
+    if (mode < 0) mode += SyncModes;
+    else if (mode >= SyncModes) mode -= SyncModes;
+    syncMode = mode;
+    stripOffset = 0;
   } else { // Other cases - just change selected item
     currentMenuItem += encoderDelta;
     if (currentMenuItem < 0) currentMenuItem = currentMenuLength + currentMenuItem;
@@ -309,11 +597,19 @@ void Glowstick::handleButtonPress() {
     currentMenuItem = 0;
     currentMenuLength = MenuLengths[displayState];
     editState = false;
+  } else if (displayState == DisplayStateScenes && currentMenuItem == SceneMenuItemRecall) {
+    sceneSlotEmpty = !recallScene(sceneSlot);
+  } else if (displayState == DisplayStateScenes && currentMenuItem == SceneMenuItemSave) {
+    saveScene(sceneSlot);
+    sceneSlotEmpty = false;
   } else if (currentMenuItem < currentMenuLength - 1 && ( // Not back button
              displayState == DisplayStateHSV ||
              displayState == DisplayStateWhite ||
              displayState == DisplayStateGradient ||
-             displayState == DisplayStateAnimation)) {
+             displayState == DisplayStateAnimation ||
+             displayState == DisplayStateScenes ||
+             displayState == DisplayStatePower ||
+             displayState == DisplayStateSync)) {
     // Change edit state in modes with multiple selectable fields
     editState = !editState;
   } else if ((currentMenuItem == currentMenuLength - 1
@@ -345,6 +641,177 @@ void Glowstick::handleButtonPress() {
   displayNeedsRedrawing = true;
 }
 
+// Reads commands from the host
+// FastLED.show() disables interrupts, so senders need to pace bytes to one per frame or slower
+// Every command starts with SerialFrameStart, which is escaped everywhere else, so it always
+// starts a new command. After a dropped byte the unfinished command is dropped at the next one and
+// the rest of its payload can't be mistaken for commands
+void Glowstick::handleSerial() {
+  uint32_t time = millis();
+  if (serialCommand && time - lastSerialRead > SerialTimeout) abortSerialCommand();
+
+  while (Serial.available() > 0) {
+    uint8_t data = Serial.read();
+    lastSerialRead = time;
+    if (data == SerialFrameStart) {
+      abortSerialCommand();
+      serialCommand = SerialFrameStart;
+      serialEscaped = false;
+      // Ends any sync packet sent before this so the reply is on its own line
+      if (syncMode == SyncModeLeader) Serial.println();
+      continue;
+    } else if (data == SerialEscape) {
+      serialEscaped = true;
+      continue;
+    } else if (serialEscaped) {
+      data ^= SerialEscapeXor;
+      serialEscaped = false;
+    }
+
+    if (!serialCommand) {
+      continue; // Between commands
+    } else if (serialCommand == SerialFrameStart) {
+      serialCommand = data;
+      serialLength = 0;
+      serialIndex = 0;
+      serialChecksum = 0;
+      if (syncMode == SyncModeFollower && serialCommand != SerialCommandSync) {
+        serialCommand = 0; // Followers only listen to the stick before them
+      } else if (serialCommand == SerialCommandShader) {
+        shaderLength = 0; // Stop running the old program
+      } else if (serialCommand == SerialCommandSync) {
+        // Sync packets have no length byte
+        serialLength = sizeof(SyncPacket);
+        serialIndex = 1;
+      } else if (serialCommand == SerialCommandCalibration) {
+        serialLength = 4;
+      } else {
+        if (serialCommand == SerialCommandTrace) traceDump(Serial);
+        else if (serialCommand == SerialCommandBenchmark) benchmarkNoise();
+        serialCommand = 0; // Commands without arguments are done
+      }
+    } else if (serialCommand == SerialCommandShader) {
+      receiveShader(data);
+    } else if (serialCommand == SerialCommandSync) {
+      receiveSync(data);
+    } else if (serialCommand == SerialCommandCalibration) {
+      receiveCalibration(data);
+    }
+  }
+}
+
+// Drops a partially received command and restores anything it changed
+void Glowstick::abortSerialCommand() {
+  if (serialCommand == SerialCommandShader) loadShader();
+  else if (serialCommand == SerialCommandCalibration) loadCalibration();
+  serialCommand = 0;
+}
+
+void Glowstick::receiveSync(uint8_t data) {
+  if (serialIndex <= serialLength) {
+    ((uint8_t *)&syncPacket)[serialIndex - 1] = data;
+    serialChecksum += data;
+    serialIndex++;
+    return;
+  }
+  serialCommand = 0;
+  if (data != serialChecksum || syncMode != SyncModeFollower) return;
+
+  lastSyncPacket = millis();
+  syncFrame = syncPacket.frame;
+  syncAnimating = syncPacket.animation != SyncNoAnimation;
+  if (syncAnimating) {
+    currentAnimation = syncPacket.animation;
+    for (uint8_t i = 0; i < AnimationParamCount; i++) {
+      animationParams[i] = syncPacket.animationParams[i] / (float)SceneParamScale;
+    }
+    animationPhase = (uint32_t)syncPacket.phase << 8;
+    syncBrightness = syncPacket.brightness;
+    stripOffset = syncPacket.offset;
+    syncFrameReady = true;
+  }
+
+  // Pass it on to the next stick before drawing to keep latency down the chain low
+  syncPacket.offset += LEDCount;
+  sendSyncPacket(syncPacket);
+}
+
+// Gains are applied as they arrive so they can be adjusted while looking at the strip
+void Glowstick::receiveCalibration(uint8_t data) {
+  if (serialIndex == 0) {
+    calibrationSegment = data;
+    serialChecksum = data;
+    if (calibrationSegment >= CalibrationSegments) {
+      Serial.println(F("ERR segment"));
+      serialCommand = 0;
+    }
+  } else if (serialIndex <= serialLength) {
+    calibration[calibrationSegment][serialIndex - 1] = data;
+    serialChecksum += data;
+  } else {
+    serialCommand = 0;
+    if (data != serialChecksum) {
+      Serial.println(F("ERR checksum"));
+      loadCalibration();
+      return;
+    }
+    uint16_t address = EEPROMAddrCalibration + calibrationSegment * 4;
+    for (uint8_t c = 0; c < 4; c++) EEPROM.update(address + c, calibration[calibrationSegment][c]);
+    loadCalibration();
+    Serial.println(F("OK"));
+    return;
+  }
+  serialIndex++;
+}
+
+void Glowstick::sendSyncPacket(SyncPacket &packet) {
+  uint8_t checksum = 0;
+  for (uint8_t i = 0; i < sizeof(SyncPacket); i++) checksum += ((uint8_t *)&packet)[i];
+  Serial.write(SerialFrameStart);
+  Serial.write(SerialCommandSync);
+  for (uint8_t i = 0; i < sizeof(SyncPacket); i++) writeEscaped(((uint8_t *)&packet)[i]);
+  writeEscaped(checksum);
+}
+
+// Program bytes go straight into shaderProgram, the previous program is reloaded if rejected
+void Glowstick::receiveShader(uint8_t data) {
+  if (serialIndex == 0) {
+    serialLength = data;
+    if (serialLength == 0 || serialLength > ShaderMaxLength) {
+      Serial.println(F("ERR length"));
+      loadShader();
+      serialCommand = 0;
+    }
+  } else if (serialIndex <= serialLength) {
+    shaderProgram[serialIndex - 1] = data;
+    serialChecksum += data;
+  } else {
+    serialCommand = 0;
+    if (data != serialChecksum) {
+      Serial.println(F("ERR checksum"));
+    } else if (!verifyShader(shaderProgram, serialLength, ShaderCycleBudget / LEDCount)) {
+      Serial.println(F("ERR invalid or too slow"));
+    } else {
+      shaderLength = serialLength;
+      uint32_t frameCycles = measureShader();
+      if (frameCycles <= ShaderCycleBudget) {
+        EEPROM.put(EEPROMAddrShader, shaderLength);
+        for (uint8_t i = 0; i < shaderLength; i++) {
+          EEPROM.update(EEPROMAddrShader + 1 + i, shaderProgram[i]);
+        }
+        Serial.print(F("OK "));
+        Serial.println(frameCycles);
+        return;
+      }
+      Serial.print(F("ERR too slow "));
+      Serial.println(frameCycles);
+    }
+    loadShader();
+    return;
+  }
+  serialIndex++;
+}
+
 // EEPROM
 
 void Glowstick::writeEEPROMSettings() {
@@ -353,34 +820,168 @@ void Glowstick::writeEEPROMSettings() {
   EEPROM.put(EEPROMAddrDisplayBrightness, displayBrightness);
   EEPROM.put(EEPROMAddrGradient0, gradientColors[0]);
   EEPROM.put(EEPROMAddrGradient1, gradientColors[1]);
+  EEPROM.put(EEPROMAddrSceneFadeTime, sceneFadeTime);
+  EEPROM.put(EEPROMAddrPowerBudget, powerBudget);
+  EEPROM.put(EEPROMAddrSyncMode, syncMode);
+}
+
+// Scenes
+
+void Glowstick::saveScene(uint8_t slot) {
+  Scene scene;
+  scene.mode = ledMode;
+  scene.animation = currentAnimation;
+  scene.colorMode = selectedColorMode;
+  scene.hsv = hsvValue;
+  scene.white = whiteValue;
+  scene.gradient[0] = gradientColors[0];
+  scene.gradient[1] = gradientColors[1];
+  for (uint8_t i = 0; i < AnimationParamCount; i++) {
+    scene.animationParams[i] = animationParams[i] * SceneParamScale;
+  }
+  EEPROM.put(EEPROMAddrScenes + slot * sizeof(Scene), scene);
+}
+
+// Loads a scene and starts fading to it, returns false if the slot is empty
+bool Glowstick::recallScene(uint8_t slot) {
+  Scene scene;
+  EEPROM.get(EEPROMAddrScenes + slot * sizeof(Scene), scene);
+  if (scene.mode > DisplayStateGradient && scene.mode != DisplayStateAnimation) return false;
+
+  ledMode = scene.mode;
+  currentAnimation = scene.animation;
+  selectedColorMode = scene.colorMode;
+  hsvValue = scene.hsv;
+  whiteValue = scene.white;
+  gradientColors[0] = scene.gradient[0];
+  gradientColors[1] = scene.gradient[1];
+  for (uint8_t i = 0; i < AnimationParamCount; i++) {
+    animationParams[i] = scene.animationParams[i] / (float)SceneParamScale;
+  }
+  crossfadeFrames = (uint16_t)sceneFadeTime * 100 / UpdateInterval;
+  return true;
+}
+
+// Custom animation and calibration
+
+void Glowstick::loadShader() {
+  EEPROM.get(EEPROMAddrShader, shaderLength);
+  if (shaderLength > ShaderMaxLength) shaderLength = 0; // Never written
+  for (uint8_t i = 0; i < shaderLength; i++) {
+    shaderProgram[i] = EEPROM.read(EEPROMAddrShader + 1 + i);
+  }
+  if (!verifyShader(shaderProgram, shaderLength, ShaderCycleBudget / LEDCount) ||
+      measureShader() > ShaderCycleBudget) {
+    shaderLength = 0;
+  }
+}
+
+void Glowstick::loadCalibration() {
+  for (uint8_t i = 0; i < CalibrationSegments; i++) {
+    for (uint8_t c = 0; c < 4; c++) {
+      calibration[i][c] = EEPROM.read(EEPROMAddrCalibration + i * 4 + c);
+    }
+  }
+}
+
+// Times one frame of the custom animation in CPU cycles, in gradient mode since it converts a
+// color for every pixel
+// Per op costs and color conversion vary too much to estimate, so this is what programs are held to
+// The frame goes through setLED as usual but into a scratch pixel, the strip and the current
+// estimate are left as they were
+uint32_t Glowstick::measureShader() {
+  uint8_t animation = currentAnimation;
+  uint8_t colorMode = selectedColorMode;
+  uint32_t load = ledLoad;
+  currentAnimation = AnimationCustom;
+  selectedColorMode = DisplayStateGradient;
+  measuringShader = true;
+  uint32_t start = micros();
+  drawAnimationFrame(animationPhase >> 8);
+  uint32_t cycles = (micros() - start) * (F_CPU / 1000000);
+  measuringShader = false;
+  currentAnimation = animation;
+  selectedColorMode = colorMode;
+  ledLoad = load;
+  return cycles;
 }
 
 // LED drawing
 
+// All drawing goes through here so crossfades can blend into the existing frame
+// and the power estimate can be updated without another pass over the LEDs
+// leds is also the output buffer, so calibration is applied here instead of in a separate pass
+// Crossfades blend between calibrated colors, which is the same since the gains are linear
+void Glowstick::setLED(uint8_t index, RGBW color) {
+  const uint8_t *gain = calibration[index / CalibrationSegmentLength];
+  for (uint8_t c = 0; c < 4; c++) color.raw[c] = scale8(color.raw[c], gain[c]);
+
+  // measureShader() draws a frame into one scratch pixel so timing it doesn't touch the strip
+  RGBW &led = measuringShader ? shaderScratchLED : leds[index];
+  ledLoad -= ledCurrent(led);
+  if (crossfadeAmount) {
+    uint16_t dither = random16();
+    for (uint8_t c = 0; c < 4; c++) {
+      led.raw[c] = crossfade8(led.raw[c], color.raw[c], crossfadeAmount, dither);
+    }
+  } else {
+    led = color;
+  }
+  ledLoad += ledCurrent(led);
+}
+
+// Limit LED brightness to stay within the power budget and update the current estimate
+// Drops immediately to avoid brownouts and recovers gradually to avoid visible pumping
+uint8_t Glowstick::limitBrightness(uint8_t brightness) {
+  uint16_t fixedCurrent = (uint16_t)LEDCount * LEDIdleCurrent + BaseCurrent;
+  uint8_t maxBrightness = 255;
+  if (ledLoad > 0 && powerBudget > fixedCurrent) {
+    maxBrightness = min((uint32_t)(powerBudget - fixedCurrent) * 65025 / ledLoad, 255UL);
+  } else if (ledLoad > 0) {
+    maxBrightness = 0;
+  }
+
+  if (maxBrightness < powerLimit) powerLimit = maxBrightness;
+  else powerLimit = min(powerLimit + PowerLimitRecoverySpeed, maxBrightness);
+
+  brightness = min(brightness, powerLimit);
+  estimatedCurrent = ledLoad * brightness / 65025 + fixedCurrent;
+  return brightness;
+}
+
 void Glowstick::setAllLEDs(RGBW color) {
-  for (uint8_t i = 0; i < LEDCount; i++) leds[i] = color;
+  for (uint8_t i = 0; i < LEDCount; i++) setLED(i, color);
 }
 
 void Glowstick::drawGradient(uint8_t startIndex, uint8_t endIndex, HSV start, HSV end) {
   int16_t startHue = start.h > end.h ? start.h - 256 : start.h;
   for (uint8_t i = startIndex; i < endIndex; i++) {
-    leds[i] = hsv2rgbw(HSV(map(i, startIndex, endIndex, startHue, end.h),
+    setLED(i, hsv2rgbw(HSV(map(i, startIndex, endIndex, startHue, end.h),
                            map(i, startIndex, endIndex, start.s, end.s),
-                           map(i, startIndex, endIndex, start.v, end.v)), ColorCorrection);
+                           map(i, startIndex, endIndex, start.v, end.v)), ColorCorrection));
   }
 }
 
-void Glowstick::drawAnimationFrame(uint32_t timeMillis) {
-  // Get correct time input to animation and selected color
-  float t = timeMillis / 1000.0 * animationParams[0];
+void Glowstick::drawAnimationFrame(uint16_t phase) {
+  if (currentAnimation >= AnimationPlasma) {
+    drawNoiseFrame(phase);
+    return;
+  }
+
+  // Get selected color
   RGBW c;
   if (selectedColorMode == DisplayStateHSV) c = hsv2rgbw(hsvValue, ColorCorrection);
   else if (selectedColorMode == DisplayStateWhite) c = RGBW(0, 0, 0, whiteValue);
   int16_t startHue = gradientColors[0].h > gradientColors[1].h ? gradientColors[0].h - 256 :
                                                                  gradientColors[0].h;
+  // Everything per pixel is fixed point, 256 = one cycle
+  uint8_t phase8 = phase >> 8;
+  uint8_t sectorPhase = (uint16_t)(phase * LEDSectorCount) >> 8;
+  uint16_t positionStep = 65536.0 * animationParams[1] / LEDCount; // 8.8 fixed point
+  fract8 shape = animationParams[2] * 25.5;
 
   for (uint8_t i = 0; i < LEDCount; i++) {
-    float x = i / (float)LEDCount * animationParams[1]; // Get scaled position
+    uint16_t position = (uint32_t)(stripOffset + i) * positionStep >> 8; // Scaled position
     // If using gradient, get pixel color
     if (selectedColorMode == DisplayStateGradient) {
       c = hsv2rgbw(HSV(map(i, 0, LEDCount, startHue, gradientColors[1].h),
@@ -389,26 +990,124 @@ void Glowstick::drawAnimationFrame(uint32_t timeMillis) {
                        ColorCorrection);
     }
 
+    // Animations with a shape blend between a hard and a smooth brightness waveform
     if (currentAnimation == AnimationCycleHue) {
-      leds[i] = hsv2rgbw(t + x, 255, 128, ColorCorrection);
+      setLED(i, paletteColor(RainbowPalette, phase8 + position));
     } else if (currentAnimation == AnimationFlash) {
-      leds[i] = fmod(t + x, 1.0) < 0.5 ? c : LEDOff;
+      uint8_t p = phase8 + position;
+      setLED(i, scaleRGBW(c, lerp8by8(pulseWave8(p, 128), sineWave8(p), shape)));
     } else if (currentAnimation == AnimationCheckerboard) {
-      leds[i] = (fmod(x * LEDSectorCount, 1.0) < 0.5) == (fmod(t * LEDSectorCount, 1.0) < 0.5) ?
-                c : LEDOff;
+      uint8_t p = position * LEDSectorCount;
+      uint8_t hard = pulseWave8(p, 128) == pulseWave8(sectorPhase, 128) ? 255 : 0;
+      // Product of two sines is positive where both have the same sign, like the checkerboard
+      int16_t product = ((int16_t)sineWave8(p) - 128) * ((int16_t)sineWave8(sectorPhase) - 128);
+      uint8_t smooth = min(128 + (product >> 7), 255);
+      setLED(i, scaleRGBW(c, lerp8by8(hard, smooth, shape)));
     } else if (currentAnimation == AnimationTriangles) {
-      leds[i] = fmod(x, 1.0) < fmod(t, 1.0) ? c : LEDOff;
+      // Smooth triangles grow and shrink instead of restarting, with soft edges
+      uint8_t front = lerp8by8(phase8, triangleWave8(phase8), shape);
+      int16_t distance = (int16_t)front - (uint8_t)position;
+      uint8_t hard = distance > 0 ? 255 : 0;
+      uint8_t smooth = easeInOut8(constrain(128 + distance * AnimationSoftEdgeSlope, 0, 255));
+      setLED(i, scaleRGBW(c, lerp8by8(hard, smooth, shape)));
     } else if (currentAnimation == AnimationFire) { // Very crude but it works
-      leds[i].w = qsub8(leds[i].w, random8(1, 4));
-      if (i < LEDCount - 1 && random8() < 48 * animationParams[0]) {
-        leds[i].w = (leds[i + 1].w + leds[i + 1].w + leds[i + 2].w) / 3;
+      uint8_t heat = qsub8(fireHeat[i], random8(1, 4));
+      if (i < LEDCount - 2 && random8() < 48 * animationParams[0]) {
+        heat = (fireHeat[i + 1] + fireHeat[i + 1] + fireHeat[i + 2]) / 3;
       }
-      if (x > 0.5 && random8() < 3 * animationParams[0]) {
-        leds[i].w = qadd8(leds[i].w, random8(16, 255));
+      if (position > 128 && random8() < 3 * animationParams[0]) {
+        heat = qadd8(heat, random8(16, 255));
       }
-      leds[i].r = qsub8(c.r, leds[i].w - 1);
-      leds[i].g = qsub8(c.g, leds[i].w - 1);
-      leds[i].b = qsub8(c.b, leds[i].w - 1);
+      fireHeat[i] = heat;
+      setLED(i, RGBW(qsub8(c.r, heat - 1), qsub8(c.g, heat - 1), qsub8(c.b, heat - 1), heat));
+    } else if (currentAnimation == AnimationCustom) {
+      if (!shaderLength) {
+        setLED(i, LEDOff);
+        continue;
+      }
+      ShaderResult result = runShader(shaderProgram, phase8, position);
+      if (result.source == ShaderSourceColor) {
+        setLED(i, scaleRGBW(c, result.value));
+      } else {
+        setLED(i, hsv2rgbw(blendHSV(gradientColors[0], gradientColors[1], result.value),
+                           ColorCorrection));
+      }
+    }
+  }
+}
+
+// Noise animations have their own loop so gradients can use a few colors converted once per frame,
+// a color conversion per pixel wouldn't leave enough time for longer strips
+void Glowstick::drawNoiseFrame(uint16_t phase) {
+  RGBW c = LEDOff;
+  RGBW stops[NoiseGradientStops + 1];
+  if (selectedColorMode == DisplayStateHSV) c = hsv2rgbw(hsvValue, ColorCorrection);
+  else if (selectedColorMode == DisplayStateWhite) c = RGBW(0, 0, 0, whiteValue);
+  else {
+    for (uint8_t i = 0; i <= NoiseGradientStops; i++) {
+      stops[i] = hsv2rgbw(blendHSV(gradientColors[0], gradientColors[1],
+                                   min(i * 256 / NoiseGradientStops, 255)), ColorCorrection);
+    }
+  }
+
+  // Lattice cells per cycle in time and per pattern length along the strip (as a shift)
+  uint8_t timeCells = 4, spaceShift = 2;
+  if (currentAnimation == AnimationLava) timeCells = 1, spaceShift = 1;
+  else if (currentAnimation == AnimationShimmer) timeCells = 16, spaceShift = 4;
+
+  uint16_t positionStep = 65536.0 * animationParams[1] / LEDCount; // 8.8 fixed point
+  fract8 shape = animationParams[2] * 25.5;
+  uint16_t first = (uint32_t)stripOffset * positionStep >> 8;
+  uint16_t last = (uint32_t)(stripOffset + LEDCount - 1) * positionStep >> 8;
+  noise.begin(phase, timeCells, first << spaceShift, last << spaceShift);
+
+  for (uint8_t i = 0; i < LEDCount; i++) {
+    uint16_t position = (uint32_t)(stripOffset + i) * positionStep >> 8;
+    uint8_t value = noise.get(position << spaceShift);
+    // Plasma and lava pick gradient colors by value, shimmer keeps the gradient along the strip
+    uint8_t gradientIndex = value;
+
+    if (currentAnimation == AnimationLava) {
+      // Blobs with hard edges blending to smooth like the other shaped animations
+      uint8_t hard = value > 128 ? 255 : 0;
+      uint8_t smooth = easeInOut8(constrain(128 + (value - 128) * NoiseLavaContrast, 0, 255));
+      value = lerp8by8(hard, smooth, shape);
+      gradientIndex = value;
+    } else if (currentAnimation == AnimationShimmer) {
+      value = NoiseShimmerFloor + scale8(scale8(value, value), 255 - NoiseShimmerFloor);
+      gradientIndex = (uint16_t)i * 256 / LEDCount;
     }
+
+    if (selectedColorMode == DisplayStateGradient) {
+      uint8_t stop = gradientIndex / (256 / NoiseGradientStops);
+      RGBW color = blendRGBW(stops[stop], stops[stop + 1],
+                             gradientIndex % (256 / NoiseGradientStops) * NoiseGradientStops);
+      setLED(i, currentAnimation == AnimationShimmer ? scaleRGBW(color, value) : color);
+    } else {
+      setLED(i, scaleRGBW(c, value));
+    }
+  }
+}
+
+// Times each noise animation and scales it to NoiseMaxLEDs to check that it fits the render budget
+// Gradient mode is the slowest, blending colors for every pixel
+// Run by tools/benchmark.py
+void Glowstick::benchmarkNoise() {
+#ifdef GLOWSTICK_TRACE
+  uint8_t animation = currentAnimation;
+  uint8_t colorMode = selectedColorMode;
+  selectedColorMode = DisplayStateGradient;
+  for (currentAnimation = AnimationPlasma; currentAnimation <= AnimationShimmer;
+       currentAnimation++) {
+    uint32_t start = micros();
+    drawNoiseFrame(animationPhase >> 8);
+    uint32_t cycles = (micros() - start) * (F_CPU / 1000000) * NoiseMaxLEDs / LEDCount;
+    Serial.print(currentAnimation);
+    Serial.print(' ');
+    Serial.print(cycles);
+    Serial.println(cycles <= ShaderCycleBudget ? F(" OK") : F(" ERR"));
   }
+  currentAnimation = animation;
+  selectedColorMode = colorMode;
+#endif
 }
@@ -12,16 +12,47 @@
 
 #include "constants.hpp"
 #include "fastledrgbw.hpp"
+#include "frameoutput.hpp"
 #include "menus.hpp"
+#include "noise.hpp"
+#include "shadervm.hpp"
+#include "trace.hpp"
+#include "waveforms.hpp"
+
+// Everything needed to restore a look, packed for EEPROM storage
+struct Scene {
+  uint8_t mode : 4; // DisplayState that renders the scene, 0xF if the slot is empty
+  uint8_t animation : 4;
+  uint8_t colorMode;
+  HSV hsv;
+  uint8_t white;
+  HSV gradient[2];
+  uint16_t animationParams[AnimationParamCount]; // Fixed point, see SceneParamScale
+};
+
+// Sent by the leader every frame and relayed down the chain by each follower
+struct SyncPacket {
+  uint8_t frame;
+  uint16_t phase; // Animation phase, 65536 = one cycle
+  uint8_t animation; // SyncNoAnimation if the leader isn't showing one
+  uint8_t brightness; // Leader's fade in/out state
+  uint16_t animationParams[AnimationParamCount]; // Fixed point, see SceneParamScale
+  uint16_t offset; // Position of the receiving stick's first LED on the combined strip
+} __attribute__((packed));
 
 class Glowstick {
   public:
     Glowstick();
+    Glowstick(FrameOutput *output);
     void init();
     void tick();
+    uint16_t getEstimatedCurrent() { return estimatedCurrent; } // mA, as of the last frame
 
   private:
-    RGBW leds[LEDCount];
+    RGBW leds[LEDCount]; // render buffer, also read back by crossfades
+    // Fire animation state, kept apart from leds since calibration would lose resolution
+    uint8_t fireHeat[LEDCount] = {0};
+    FrameOutput *output = &fastLEDOutput;
     U8G2_SSD1306_128X32_UNIVISION_F_HW_I2C u8g2 = U8G2_SSD1306_128X32_UNIVISION_F_HW_I2C(U8G2_R2);
 
     bool prevButtonState = false;
@@ -33,6 +64,7 @@ class Glowstick {
     uint8_t displayBrightness = 96;
     bool displayOn = true;
     bool displayNeedsRedrawing = true;
+    uint8_t labelledScreen = 255; // DisplayState whose labels are in the frame buffer, 255 if none
     uint8_t displayState = DisplayStateMenu;
     int8_t currentMenuItem = 0;
     uint8_t currentMenuLength = MainMenuItems;
@@ -47,8 +79,53 @@ class Glowstick {
 
     uint8_t currentAnimation = 0;
     // Speed and scale (1-255 represents 6/255hz to 6hz; 0-255 represents 0-???)
-    float animationParams[2] = {1.0, 1.0};
+    // Shape blends from hard edged (0) to smooth (10) waveforms
+    float animationParams[AnimationParamCount] = {1.0, 1.0, 0.0};
+    uint32_t animationPhase = 0; // 8.24 fixed point cycles
+
+    uint8_t ledMode = DisplayStateHSV; // what was last drawn on the LEDs (shown on scene screen)
+    uint8_t sceneSlot = 0;
+    bool sceneSlotEmpty = false; // Recall was tried on an empty slot
+    uint8_t sceneFadeTime = SceneDefaultFadeTime;
+    uint16_t crossfadeFrames = 0; // frames left in the current crossfade
+    uint16_t crossfadeAmount = 0; // fraction of the remaining distance to cover this frame
+
+    uint32_t ledLoad = 0; // sum of channel values weighted by current, kept up to date by setLED
+    uint16_t powerBudget = PowerDefaultBudget;
+    uint8_t powerLimit = 255; // maximum LED brightness allowed by the power budget
+    uint16_t estimatedCurrent = 0; // mA
 
+    uint8_t shaderProgram[ShaderMaxLength];
+    uint8_t shaderLength = 0; // 0 if there is no valid program
+    bool measuringShader = false;
+    RGBW shaderScratchLED; // setLED draws here while measureShader times a frame
+    NoiseStrip noise; // keeps samples between frames
+
+    uint8_t calibration[CalibrationSegments][4]; // gain per channel in GRBW order
+    uint8_t calibrationSegment = 0; // segment being received
+
+    uint8_t serialCommand = 0; // command being received, 0 if waiting for one
+    uint8_t serialLength = 0;
+    uint8_t serialIndex = 0;
+    uint8_t serialChecksum = 0;
+    bool serialEscaped = false; // next byte was escaped
+    uint32_t lastSerialRead = 0;
+
+    uint8_t syncMode = SyncModeOff;
+    SyncPacket syncPacket; // Receive buffer for followers
+    uint8_t syncFrame = 0;
+    uint32_t lastSyncPacket = 0;
+    bool syncFrameReady = false; // Follower received a packet and should draw a frame now
+    bool syncAnimating = false; // Leader is showing an animation
+    uint8_t syncBrightness = 0;
+    uint16_t stripOffset = 0; // Position of the first LED when sticks are combined
+
+    void redrawDisplay();
+    void sendDisplayTiles(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+    void drawLabels();
+    void drawLabel(uint8_t x, uint8_t y, const __FlashStringHelper *label);
+    void drawNumber(uint8_t x, uint8_t y, uint16_t value, uint8_t decimals = 0,
+                    const __FlashStringHelper *unit = nullptr);
     void drawScrollingMenu(const char * const *strings);
     void drawBackButton(bool highlight);
     void drawSlider(uint8_t line, uint8_t left, uint8_t width,
@@ -60,14 +137,36 @@ class Glowstick {
     void drawWhiteControls();
     void drawGradientControls();
     void drawAnimationControls();
+    void drawSceneControls();
+    void drawPowerControls();
+    void drawSyncControls();
     void drawBrightnessControls();
 
+    void handleInput(uint32_t time);
+    void renderFrame(uint32_t time, bool following);
+    uint8_t postProcessFrame(bool following);
+
     void handleEncoderChange();
     void handleButtonPress();
+    void handleSerial();
+    void abortSerialCommand();
+    void receiveShader(uint8_t data);
+    void receiveSync(uint8_t data);
+    void receiveCalibration(uint8_t data);
+    void sendSyncPacket(SyncPacket &packet);
 
     void writeEEPROMSettings();
+    void saveScene(uint8_t slot);
+    bool recallScene(uint8_t slot);
+    void loadShader();
+    uint32_t measureShader();
+    void loadCalibration();
 
+    void setLED(uint8_t index, RGBW color);
+    uint8_t limitBrightness(uint8_t brightness);
     void setAllLEDs(RGBW color);
     void drawGradient(uint8_t startIndex, uint8_t endIndex, HSV start, HSV end);
-    void drawAnimationFrame(uint32_t timeMillis);
+    void drawAnimationFrame(uint16_t phase);
+    void drawNoiseFrame(uint16_t phase);
+    void benchmarkNoise();
 };
@@ -6,12 +6,17 @@
 #include <stdint.h>
 #include <avr/pgmspace.h>
 
+#include "constants.hpp"
+
 // All possible display states ("screens")
 typedef enum : uint8_t {
   DisplayStateHSV,
   DisplayStateWhite,
   DisplayStateGradient,
   DisplayStateAnimationMenu,
+  DisplayStateScenes,
+  DisplayStatePower,
+  DisplayStateSync,
   DisplayStateBrightness,
   DisplayStateMenu,
   DisplayStateAnimation
@@ -23,6 +28,9 @@ typedef enum : uint8_t { // Main menu items must match up with respective Displa
   MenuItemWhite,
   MenuItemGradient,
   MenuItemAnimation,
+  MenuItemScenes,
+  MenuItemPower,
+  MenuItemSync,
   MenuItemDisplayBrightness,
   MainMenuItems
 } MainMenuItem;
@@ -32,14 +40,20 @@ const char MainMenu01[] PROGMEM = "Color";
 const char MainMenu02[] PROGMEM = "White";
 const char MainMenu03[] PROGMEM = "Gradient";
 const char MainMenu04[] PROGMEM = "Animations";
-const char MainMenu05[] PROGMEM = "Display Brightness";
+const char MainMenu05[] PROGMEM = "Scenes";
+const char MainMenu06[] PROGMEM = "Power";
+const char MainMenu07[] PROGMEM = "Sync";
+const char MainMenu08[] PROGMEM = "Display Brightness";
 
 const char * const MainMenuStrings[] PROGMEM = {
   MainMenu01,
   MainMenu02,
   MainMenu03,
   MainMenu04,
-  MainMenu05
+  MainMenu05,
+  MainMenu06,
+  MainMenu07,
+  MainMenu08
 };
 
 // Screen submenu items
@@ -75,6 +89,10 @@ typedef enum : uint8_t {
   AnimationCheckerboard,
   AnimationTriangles,
   AnimationFire,
+  AnimationCustom,
+  AnimationPlasma,
+  AnimationLava,
+  AnimationShimmer,
   AnimationMenuItemBack,
   Animations
 } AnimationMenuItem;
@@ -85,7 +103,11 @@ const char AnimationMenu02[] PROGMEM = "Flash/Scan";
 const char AnimationMenu03[] PROGMEM = "Checkerboard";
 const char AnimationMenu04[] PROGMEM = "Triangles";
 const char AnimationMenu05[] PROGMEM = "Fire";
-const char AnimationMenu06[] PROGMEM = "Back";
+const char AnimationMenu06[] PROGMEM = "Custom";
+const char AnimationMenu07[] PROGMEM = "Plasma";
+const char AnimationMenu08[] PROGMEM = "Lava";
+const char AnimationMenu09[] PROGMEM = "Shimmer";
+const char AnimationMenu10[] PROGMEM = "Back";
 
 const char * const AnimationMenuStrings[] PROGMEM = {
   AnimationMenu01,
@@ -93,21 +115,68 @@ const char * const AnimationMenuStrings[] PROGMEM = {
   AnimationMenu03,
   AnimationMenu04,
   AnimationMenu05,
-  AnimationMenu06
+  AnimationMenu06,
+  AnimationMenu07,
+  AnimationMenu08,
+  AnimationMenu09,
+  AnimationMenu10
 };
 
 typedef enum : uint8_t {
   AnimationControlMenuItemSpeed,
   AnimationControlMenuItemScale,
+  AnimationControlMenuItemShape,
   AnimationControlMenuItemBack,
   AnimationControlMenuItems
 } AnimationControlMenuItem;
 
+typedef enum : uint8_t {
+  SceneMenuItemSlot,
+  SceneMenuItemFade,
+  SceneMenuItemRecall,
+  SceneMenuItemSave,
+  SceneMenuItemBack,
+  SceneMenuItems
+} SceneMenuItem;
+
+typedef enum : uint8_t {
+  PowerMenuItemBudget,
+  PowerMenuItemBack,
+  PowerMenuItems
+} PowerMenuItem;
+
+typedef enum : uint8_t {
+  SyncMenuItemMode,
+  SyncMenuItemBack,
+  SyncMenuItems
+} SyncMenuItem;
+
+// Multi-stick sync roles
+typedef enum : uint8_t {
+  SyncModeOff,
+  SyncModeLeader,
+  SyncModeFollower,
+  SyncModes
+} SyncMode;
+
+const char SyncMode01[] PROGMEM = "Off";
+const char SyncMode02[] PROGMEM = "Leader";
+const char SyncMode03[] PROGMEM = "Follower";
+
+const char * const SyncModeStrings[] PROGMEM = {
+  SyncMode01,
+  SyncMode02,
+  SyncMode03
+};
+
 // Lengths of submenus for each DisplayState
 // 0 if the DisplayState does not have a submenu
-const uint8_t MenuLengths[5] {
-  HSVMenuItems, WhiteMenuItems, GradientMenuItems, Animations, 0
+const uint8_t MenuLengths[8] {
+  HSVMenuItems, WhiteMenuItems, GradientMenuItems, Animations, SceneMenuItems, PowerMenuItems,
+  SyncMenuItems, 0
 };
 
-// Size of buffer for storing strings as they are unloaded from PROGMEM
-const uint8_t MenuStringBufferSize = 20;
+// Top left corner of the part of each screen that changes while it's shown, indexed by DisplayState
+// Labels outside of it are only drawn when the screen is first shown (see drawLabels)
+const uint8_t ScreenValueLeft[] = {24, 16, 24, 0, 0, 62, 0, 16, 0, 48};
+const uint8_t ScreenValueTop[] = {0, LineHeight, 0, 0, 0, 0, 0, LineHeight, 0, 0};
@@ -0,0 +1,64 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include <FastLED.h>
+
+#include "noise.hpp"
+
+// Anywhere away from 0 so the circle doesn't wrap
+const uint16_t NoiseCircleCenter = 0x8000;
+
+void NoiseStrip::begin(uint16_t phase, uint8_t cellsPerCycle, uint16_t xStart, uint16_t xEnd) {
+  // Smallest grid that covers the strip
+  uint16_t span = xEnd - xStart;
+  uint8_t gridShift = 0;
+  while (gridShift <= NoiseMaxSampleShift && span >> gridShift >= NoiseSamples - 1) gridShift++;
+  if (cellsPerCycle != cells || xStart != origin || gridShift != shift) valid = false;
+  cells = cellsPerCycle;
+  origin = xStart;
+  shift = gridShift;
+  direct = shift > NoiseMaxSampleShift;
+  // Circumference of cellsPerCycle cells, 40.74 = 256 / 2pi
+  radius = cellsPerCycle * 40.74;
+
+  if (direct) {
+    y = NoiseCircleCenter + ((int32_t)cos16(phase) * radius >> 15);
+    z = NoiseCircleCenter + ((int32_t)sin16(phase) * radius >> 15);
+    return;
+  }
+
+  // Move to the keyframes on either side of phase, reusing a row if possible
+  uint16_t keyframes = cellsPerCycle * NoiseKeyframesPerCell;
+  uint32_t position = (uint32_t)phase * keyframes; // 16.16 fixed point keyframes
+  uint16_t current = position >> 16;
+  timeFraction = position >> 8;
+  uint16_t next = current + 1 < keyframes ? current + 1 : 0;
+  if (valid && current == keyframe) return;
+  if (valid && (keyframe + 1 < keyframes ? keyframe + 1 : 0) == current) {
+    first ^= 1;
+  } else {
+    computeRow(first, (uint32_t)current * 65536 / keyframes);
+  }
+  computeRow(first ^ 1, (uint32_t)next * 65536 / keyframes);
+  keyframe = current;
+  valid = true;
+}
+
+void NoiseStrip::computeRow(uint8_t row, uint16_t angle) {
+  uint16_t rowY = NoiseCircleCenter + ((int32_t)cos16(angle) * radius >> 15);
+  uint16_t rowZ = NoiseCircleCenter + ((int32_t)sin16(angle) * radius >> 15);
+  for (uint8_t i = 0; i < NoiseSamples; i++) {
+    rows[row][i] = inoise8(origin + ((uint16_t)i << shift), rowY, rowZ);
+  }
+}
+
+uint8_t NoiseStrip::get(uint16_t x) {
+  if (direct) return inoise8(x, y, z);
+  uint16_t offset = x - origin;
+  uint8_t i = offset >> shift;
+  uint8_t f = offset << (8 - shift);
+  const uint8_t *now = rows[first];
+  const uint8_t *next = rows[first ^ 1];
+  return lerp8by8(lerp8by8(now[i], next[i], timeFraction),
+                  lerp8by8(now[i + 1], next[i + 1], timeFraction), f);
+}
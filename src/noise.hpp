@@ -0,0 +1,46 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+
+// Noise along the strip that changes smoothly over time, built on FastLED's inoise8
+// Time goes around a circle through 3D noise so the pattern repeats every animation cycle, which
+// followers need since they only get the phase within a cycle from the leader
+// inoise8 is sampled on a grid along the strip and at keyframes a fraction of a lattice cell apart
+// in time. Pixels are interpolated between the samples on either side and frames between the
+// keyframes on either side, so a row of samples is only computed when a frame passes a keyframe
+// and each sample is shared by the pixels around it. Patterns too fine for the grid to follow call
+// inoise8 for every pixel
+const uint8_t NoiseSamples = 33; // per row
+const uint8_t NoiseMaxSampleShift = 6; // samples are at most 2^6 = 1/4 cell apart
+const uint8_t NoiseKeyframesPerCell = 8;
+
+class NoiseStrip {
+  public:
+    // phase is the animation phase (65536 = one cycle), the pattern moves through cellsPerCycle
+    // lattice cells each cycle
+    // xStart and xEnd are the positions of the first and last pixel in 8.8 fixed point cells
+    void begin(uint16_t phase, uint8_t cellsPerCycle, uint16_t xStart, uint16_t xEnd);
+    // x must be between xStart and xEnd
+    uint8_t get(uint16_t x);
+
+  private:
+    void computeRow(uint8_t row, uint16_t angle);
+
+    uint8_t rows[2][NoiseSamples];
+    uint8_t first = 0; // row at keyframe, the other one is at keyframe + 1
+    uint16_t keyframe = 0;
+    bool valid = false; // rows match the grid below and keyframe
+
+    // Grid
+    uint8_t cells = 0;
+    uint16_t origin = 0;
+    uint8_t shift = 0; // samples are 2^shift apart
+    bool direct = false;
+
+    uint8_t timeFraction = 0; // between the two rows
+    uint16_t radius = 0; // of the time circle
+    uint16_t y = 0, z = 0; // current time for direct lookups
+};
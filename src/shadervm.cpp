@@ -0,0 +1,70 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include "shadervm.hpp"
+
+#include <avr/pgmspace.h>
+#include <FastLED.h>
+
+// Approximate cost of each op on a 16MHz AVR including dispatch, only used to turn away programs
+// that can't fit before timing them
+const uint8_t ShaderOpCycles[ShaderOps] PROGMEM = {
+  20, // Push
+  16, // Phase
+  16, // Position
+  18, // Dup
+  20, // Swap
+  18, // Add
+  20, // QAdd
+  20, // QSub
+  40, // Sin8
+  24, // Scale8
+  20, // Color
+  20  // Palette
+};
+
+// Stack values consumed and produced by each op
+const uint8_t ShaderOpPops[ShaderOps] PROGMEM = {0, 0, 0, 1, 2, 2, 2, 2, 1, 2, 1, 1};
+const uint8_t ShaderOpPushes[ShaderOps] PROGMEM = {1, 1, 1, 2, 2, 1, 1, 1, 1, 1, 0, 0};
+
+uint16_t verifyShader(const uint8_t *program, uint8_t length, uint16_t maxCycles) {
+  if (length == 0 || length > ShaderMaxLength) return 0;
+  uint16_t cycles = 0;
+  uint8_t depth = 0;
+  for (uint8_t pc = 0; pc < length; pc++) {
+    uint8_t op = program[pc];
+    if (op >= ShaderOps) return 0;
+    uint8_t pops = pgm_read_byte(&ShaderOpPops[op]);
+    if (depth < pops) return 0; // Stack underflow
+    depth = depth - pops + pgm_read_byte(&ShaderOpPushes[op]);
+    if (depth > ShaderStackSize) return 0;
+    cycles += pgm_read_byte(&ShaderOpCycles[op]);
+    if (cycles > maxCycles) return 0;
+    if (op == ShaderOpPush && ++pc >= length) return 0; // Missing operand
+    if (op == ShaderOpColor || op == ShaderOpPalette) {
+      return pc == length - 1 ? cycles : 0; // Output must be the last op
+    }
+  }
+  return 0; // Never produced an output
+}
+
+ShaderResult runShader(const uint8_t *program, uint8_t phase, uint8_t position) {
+  uint8_t stack[ShaderStackSize];
+  uint8_t *top = stack - 1;
+  while (true) {
+    switch (*program++) {
+      case ShaderOpPush: *++top = *program++; break;
+      case ShaderOpPhase: *++top = phase; break;
+      case ShaderOpPosition: *++top = position; break;
+      case ShaderOpDup: top[1] = top[0]; top++; break;
+      case ShaderOpSwap: { uint8_t a = top[0]; top[0] = top[-1]; top[-1] = a; } break;
+      case ShaderOpAdd: top[-1] = top[-1] + top[0]; top--; break;
+      case ShaderOpQAdd: top[-1] = qadd8(top[-1], top[0]); top--; break;
+      case ShaderOpQSub: top[-1] = qsub8(top[-1], top[0]); top--; break;
+      case ShaderOpSin8: top[0] = sin8(top[0]); break;
+      case ShaderOpScale8: top[-1] = scale8(top[-1], top[0]); top--; break;
+      case ShaderOpColor: return {ShaderSourceColor, top[0]};
+      default: return {ShaderSourcePalette, top[0]};
+    }
+  }
+}
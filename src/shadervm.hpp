@@ -0,0 +1,47 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+
+// Tiny stack machine for user-defined animations, evaluated once per pixel
+// Programs are straight-line (no jumps) so their cost can be checked before they run
+// Only uses FastLED's math functions so it can also be built and run on a host with the shims in
+// host/
+typedef enum : uint8_t {
+  ShaderOpPush,     // push the next program byte
+  ShaderOpPhase,    // push animation phase (0-255 per cycle)
+  ShaderOpPosition, // push scaled pixel position (0-255 along the strip)
+  ShaderOpDup,
+  ShaderOpSwap,
+  ShaderOpAdd,      // wrapping add
+  ShaderOpQAdd,     // saturating add
+  ShaderOpQSub,     // saturating subtract
+  ShaderOpSin8,
+  ShaderOpScale8,
+  ShaderOpColor,    // pop brightness, output the selected color at that brightness and stop
+  ShaderOpPalette,  // pop index, output the gradient color at that index and stop
+  ShaderOps
+} ShaderOp;
+
+// What the caller should draw for a pixel
+typedef enum : uint8_t {
+  ShaderSourceColor,
+  ShaderSourcePalette
+} ShaderSource;
+
+struct ShaderResult {
+  uint8_t source;
+  uint8_t value;
+};
+
+const uint8_t ShaderMaxLength = 32;
+const uint8_t ShaderStackSize = 8;
+
+// Check that a program is well formed and return its estimated cost per pixel in CPU cycles
+// Returns 0 if it's invalid or the estimate is over maxCycles
+uint16_t verifyShader(const uint8_t *program, uint8_t length, uint16_t maxCycles);
+
+// Run a verified program for one pixel
+ShaderResult runShader(const uint8_t *program, uint8_t phase, uint8_t position);
@@ -0,0 +1,94 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include "trace.hpp"
+
+#ifdef GLOWSTICK_TRACE
+
+#include <util/atomic.h>
+
+static TraceEvent traceBuffer[TraceBufferSize];
+static uint8_t traceStart = 0;
+static uint8_t traceCount = 0;
+static uint16_t traceDropped = 0; // events overwritten since the last dump
+static uint16_t traceDumps = 0; // earlier dumps since boot, a replay can only start from boot
+
+// Called from both the encoder ISR and the main loop
+void traceEvent(uint32_t time, uint8_t type, uint8_t a, uint8_t b, uint8_t c) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    uint8_t index = traceStart + traceCount;
+    if (index >= TraceBufferSize) index -= TraceBufferSize;
+    if (traceCount < TraceBufferSize) {
+      traceCount++;
+    } else {
+      traceStart = traceStart + 1 < TraceBufferSize ? traceStart + 1 : 0;
+      traceDropped++;
+    }
+    traceBuffer[index].time = time;
+    traceBuffer[index].type = type;
+    traceBuffer[index].data[0] = a;
+    traceBuffer[index].data[1] = b;
+    traceBuffer[index].data[2] = c;
+  }
+}
+
+#ifdef __AVR__
+extern uint8_t __heap_start;
+extern uint8_t *__brkval;
+const uint8_t TraceStackPattern = 0xC5;
+
+// Nothing uses malloc, so free RAM is everything between the end of the heap and the stack
+void traceStackPaint() {
+  uint8_t here;
+  uint8_t *end = &here - 16; // leave this function's frame alone
+  for (uint8_t *p = __brkval ? __brkval : &__heap_start; p < end; p++) *p = TraceStackPattern;
+}
+
+// Bytes at the bottom of free RAM the stack hasn't reached since boot
+static uint16_t traceStackUnused() {
+  uint8_t *p = __brkval ? __brkval : &__heap_start;
+  uint16_t count = 0;
+  while (*p++ == TraceStackPattern) count++;
+  return count;
+}
+#else
+void traceStackPaint() {}
+#endif
+
+// Prints and clears the trace after a header: trace <events> <dropped> <earlier dumps>
+// Then one event per line: time type a b c
+// On the device, followed by the free RAM the stack has never reached: stack <bytes>
+void traceDump(Print &out) {
+  out.print(F("trace "));
+  out.print(traceCount);
+  out.print(' ');
+  out.print(traceDropped);
+  out.print(' ');
+  out.println(traceDumps);
+  uint8_t count = traceCount;
+  for (uint8_t i = 0; i < count; i++) {
+    TraceEvent event;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      event = traceBuffer[traceStart];
+      traceStart = traceStart + 1 < TraceBufferSize ? traceStart + 1 : 0;
+      traceCount--;
+    }
+    out.print(event.time);
+    out.print(' ');
+    out.print(event.type);
+    for (uint8_t j = 0; j < 3; j++) {
+      out.print(' ');
+      out.print(event.data[j]);
+    }
+    out.println();
+  }
+#ifdef __AVR__
+  out.print(F("stack "));
+  out.println(traceStackUnused());
+#endif
+  out.println(F("end"));
+  traceDropped = 0;
+  traceDumps++;
+}
+
+#endif
@@ -0,0 +1,41 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+
+// Input and frame timing trace for reproducing timing bugs off-device with host/replay.cpp
+// Only recorded in builds with GLOWSTICK_TRACE defined (see the trace env in platformio.ini)
+typedef enum : uint8_t {
+  TraceEventEncoder, // direction (+1/-1 as int8), encoder scale after the step
+  TraceEventButton,  // button state
+  TraceEventFrame    // input+render, show and display redraw time in TraceTimeUnit
+} TraceEventType;
+
+// Frames are only recorded when they start late, overrun or redraw the display
+struct TraceEvent {
+  uint16_t time; // low bits of millis()
+  uint8_t type;
+  uint8_t data[3];
+};
+
+const uint8_t TraceBufferSize = 48;
+const uint16_t TraceTimeUnit = 256; // us
+
+// Convert a duration in us to TraceTimeUnit, saturating
+inline uint8_t traceDuration(uint32_t us) {
+  return us / TraceTimeUnit > 255 ? 255 : us / TraceTimeUnit;
+}
+
+#ifdef GLOWSTICK_TRACE
+void traceEvent(uint32_t time, uint8_t type, uint8_t a, uint8_t b = 0, uint8_t c = 0);
+void traceDump(Print &out);
+// Fills free RAM so the dump can report how much stack has never been used, call first thing
+void traceStackPaint();
+#else
+inline void traceEvent(uint32_t, uint8_t, uint8_t, uint8_t = 0, uint8_t = 0) {}
+inline void traceDump(Print &) {}
+inline void traceStackPaint() {}
+#endif
@@ -0,0 +1,93 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#include "waveforms.hpp"
+
+const uint8_t SineTable[256] PROGMEM = {
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+  176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+  245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+  255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+  245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+  176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+  128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+   79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+   37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+   10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+    0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+   10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+   37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+   79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+};
+
+const uint8_t TriangleTable[256] PROGMEM = {
+    0,   2,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,
+   32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+   64,  66,  68,  70,  72,  74,  76,  78,  80,  82,  84,  86,  88,  90,  92,  94,
+   96,  98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126,
+  128, 130, 132, 134, 136, 138, 140, 142, 144, 146, 148, 150, 152, 154, 156, 158,
+  160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180, 182, 184, 186, 188, 190,
+  192, 194, 196, 198, 200, 202, 204, 206, 208, 210, 212, 214, 216, 218, 220, 222,
+  224, 226, 228, 230, 232, 234, 236, 238, 240, 242, 244, 246, 248, 250, 252, 254,
+  255, 253, 251, 249, 247, 245, 243, 241, 239, 237, 235, 233, 231, 229, 227, 225,
+  223, 221, 219, 217, 215, 213, 211, 209, 207, 205, 203, 201, 199, 197, 195, 193,
+  191, 189, 187, 185, 183, 181, 179, 177, 175, 173, 171, 169, 167, 165, 163, 161,
+  159, 157, 155, 153, 151, 149, 147, 145, 143, 141, 139, 137, 135, 133, 131, 129,
+  127, 125, 123, 121, 119, 117, 115, 113, 111, 109, 107, 105, 103, 101,  99,  97,
+   95,  93,  91,  89,  87,  85,  83,  81,  79,  77,  75,  73,  71,  69,  67,  65,
+   63,  61,  59,  57,  55,  53,  51,  49,  47,  45,  43,  41,  39,  37,  35,  33,
+   31,  29,  27,  25,  23,  21,  19,  17,  15,  13,  11,   9,   7,   5,   3,   1,
+};
+
+const uint8_t EaseInOutTable[256] PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,
+    2,   2,   2,   3,   3,   3,   3,   4,   4,   4,   5,   5,   5,   6,   6,   6,
+    7,   7,   8,   8,   9,   9,  10,  10,  11,  11,  12,  13,  13,  14,  15,  15,
+   16,  17,  18,  19,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,
+   31,  33,  34,  35,  36,  38,  39,  41,  42,  43,  45,  46,  48,  49,  51,  53,
+   54,  56,  58,  60,  62,  63,  65,  67,  69,  71,  73,  75,  77,  80,  82,  84,
+   86,  89,  91,  94,  96,  99, 101, 104, 106, 109, 112, 114, 117, 120, 123, 126,
+  129, 132, 135, 138, 141, 143, 146, 149, 151, 154, 156, 159, 161, 164, 166, 169,
+  171, 173, 175, 178, 180, 182, 184, 186, 188, 190, 192, 193, 195, 197, 199, 201,
+  202, 204, 206, 207, 209, 210, 212, 213, 214, 216, 217, 219, 220, 221, 222, 224,
+  225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 236, 237, 238, 239,
+  240, 240, 241, 242, 242, 243, 244, 244, 245, 245, 246, 246, 247, 247, 248, 248,
+  249, 249, 249, 250, 250, 250, 251, 251, 251, 252, 252, 252, 252, 253, 253, 253,
+  253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+const uint8_t RainbowPalette[16][4] PROGMEM = {
+  {  0,  65,   0,   0},
+  {  6,  54,   0,   0},
+  { 14,  44,   0,   0},
+  { 22,  44,   0,   0},
+  { 29,  44,   0,   0},
+  { 37,  22,   0,   0},
+  { 44,   0,   0,   0},
+  { 37,   0,   9,   0},
+  { 30,   0,  19,   0},
+  { 15,   0,  40,   0},
+  {  0,   0,  61,   0},
+  {  0,  10,  50,   0},
+  {  0,  21,  41,   0},
+  {  0,  32,  31,   0},
+  {  0,  43,  19,   0},
+  {  0,  54,  10,   0},
+};
+
+// Interpolate between palette entries, wrapping around from the last entry to the first
+RGBW paletteColor(const uint8_t palette[16][4], uint8_t index) {
+  uint8_t entry = index >> 4;
+  uint8_t next = (entry + 1) & 0x0F;
+  uint8_t amount = (index & 0x0F) << 4;
+  RGBW color;
+  for (uint8_t c = 0; c < 4; c++) {
+    color.raw[c] = lerp8by8(pgm_read_byte(&palette[entry][c]), pgm_read_byte(&palette[next][c]),
+                            amount);
+  }
+  return color;
+}
@@ -0,0 +1,36 @@
+// glowstick
+// Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#include "fastledrgbw.hpp"
+
+// Lookup tables indexed by 8 bit phase (256 = one cycle), generated by tools/waveforms.py
+extern const uint8_t SineTable[256] PROGMEM;
+extern const uint8_t TriangleTable[256] PROGMEM;
+extern const uint8_t EaseInOutTable[256] PROGMEM;
+
+// 16 entry palettes in GRBW order
+extern const uint8_t RainbowPalette[16][4] PROGMEM;
+
+inline uint8_t sineWave8(uint8_t phase) {
+  return pgm_read_byte(&SineTable[phase]);
+}
+
+inline uint8_t triangleWave8(uint8_t phase) {
+  return pgm_read_byte(&TriangleTable[phase]);
+}
+
+inline uint8_t easeInOut8(uint8_t x) {
+  return pgm_read_byte(&EaseInOutTable[x]);
+}
+
+// High for the first width/256 of each cycle
+inline uint8_t pulseWave8(uint8_t phase, uint8_t width) {
+  return phase < width ? 255 : 0;
+}
+
+RGBW paletteColor(const uint8_t palette[16][4], uint8_t index);
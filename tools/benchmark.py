@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+# glowstick
+# Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+# Runs the noise animation benchmark on a glowstick built with the trace env and checks that each
+# animation fits the render budget on a strip of NoiseMaxLEDs
+# Usage: benchmark.py <port> [runs], exits with 1 if any run of an animation is too slow
+# Requires pyserial
+
+import sys
+import time
+
+import glowserial
+
+COMMAND_BENCHMARK = 'B'
+ANIMATIONS = {6: 'plasma', 7: 'lava', 8: 'shimmer'} # Must match Animation in src/menus.hpp
+
+def run(conn):
+    glowserial.send(conn, COMMAND_BENCHMARK)
+    results = {}
+    while len(results) < len(ANIMATIONS):
+        words = glowserial.read_reply(conn, tuple(str(a) + ' ' for a in ANIMATIONS)).split()
+        if not words:
+            raise RuntimeError('no reply, is this a trace build?')
+        if len(words) == 3 and words[1].isdigit():
+            results[int(words[0])] = (int(words[1]), words[2] == 'OK')
+    return results
+
+if __name__ == '__main__':
+    if len(sys.argv) not in (2, 3):
+        print('usage: benchmark.py <port> [runs]')
+        sys.exit(1)
+    runs = int(sys.argv[2]) if len(sys.argv) == 3 else 10
+    import serial
+    with serial.Serial(sys.argv[1], 115200, timeout=2) as conn:
+        time.sleep(2) # Opening the port resets the board
+        conn.reset_input_buffer()
+        cycles = {animation: [] for animation in ANIMATIONS}
+        ok = True
+        for _ in range(runs):
+            for animation, (count, fits) in run(conn).items():
+                cycles[animation].append(count)
+                ok = ok and fits
+            time.sleep(0.1)
+    print('animation   min cycles   max cycles')
+    for animation, name in sorted(ANIMATIONS.items()):
+        print('{:9} {:12} {:12}'.format(name, min(cycles[animation]), max(cycles[animation])))
+    print('OK' if ok else 'ERR over budget')
+    sys.exit(0 if ok else 1)
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# glowstick
+# Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+# Generates per segment LED gains from brightness measurements and uploads them over serial
+# Usage: calibrate.py <measurements> [port], or calibrate.py --reset <port> to clear calibration
+# Measurements are lines of "segment red green blue white" (commas are fine too), where each
+# value is the brightness of that segment with only that channel on at full, measured with a
+# light meter or read from a raw photo of the same area of each segment
+# Gains are chosen so every segment matches the dimmest one for each channel
+# Requires pyserial for uploading
+
+import sys
+import time
+
+import glowserial
+
+SEGMENTS = 14 # Must match CalibrationSegments in src/constants.hpp
+COMMAND_CALIBRATION = 'C'
+
+def parse(text):
+    measurements = {}
+    for number, line in enumerate(text.splitlines(), 1):
+        words = line.split('#')[0].replace(',', ' ').split()
+        if not words:
+            continue
+        if len(words) != 5:
+            raise ValueError('line {}: expected segment and 4 values'.format(number))
+        segment = int(words[0])
+        if segment < 0 or segment >= SEGMENTS:
+            raise ValueError('line {}: segment must be 0 to {}'.format(number, SEGMENTS - 1))
+        values = [float(w) for w in words[1:]]
+        if min(values) <= 0:
+            raise ValueError('line {}: values must be positive'.format(number))
+        measurements[segment] = values
+    return measurements
+
+# Returns {segment: [g, r, b, w]}, the order the LEDs expect
+def gains(measurements):
+    targets = [min(m[c] for m in measurements.values()) for c in range(4)]
+    table = {}
+    for segment, m in measurements.items():
+        r, g, b, w = [round(255 * targets[c] / m[c]) for c in range(4)]
+        table[segment] = [g, r, b, w]
+    return table
+
+def upload(port, table):
+    import serial
+    with serial.Serial(port, 115200, timeout=2) as conn:
+        time.sleep(2) # Opening the port resets the board
+        conn.reset_input_buffer()
+        for segment, values in sorted(table.items()):
+            checksum = (segment + sum(values)) & 0xff
+            glowserial.send(conn, COMMAND_CALIBRATION, [segment] + values + [checksum])
+            reply = glowserial.read_reply(conn)
+            if reply != 'OK':
+                return 'segment {}: {}'.format(segment, reply or 'no reply')
+        return 'OK'
+
+if __name__ == '__main__':
+    if len(sys.argv) not in (2, 3):
+        print('usage: calibrate.py <measurements> [port] | calibrate.py --reset <port>')
+        sys.exit(1)
+    if sys.argv[1] == '--reset':
+        table = {segment: [255] * 4 for segment in range(SEGMENTS)}
+    else:
+        with open(sys.argv[1]) as f:
+            table = gains(parse(f.read()))
+        print('segment    g   r   b   w')
+        for segment, values in sorted(table.items()):
+            print('{:7} {}'.format(segment, ' '.join('{:3}'.format(v) for v in values)))
+    if len(sys.argv) == 3:
+        print(upload(sys.argv[2], table))
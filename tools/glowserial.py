@@ -0,0 +1,37 @@
+# glowstick
+# Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+# Serial command framing shared by the upload tools, see handleSerial() in src/glowstick.cpp
+
+import time
+
+FRAME_START = ord('#') # Must match SerialFrameStart in src/constants.hpp
+ESCAPE = ord('}') # Must match SerialEscape
+ESCAPE_XOR = 0x20
+BYTE_DELAY = 0.015 # FastLED.show() blocks serial RX, so send at most one byte per frame
+
+# Payload bytes that look like framing are escaped so a frame start is never part of a payload
+def frame(command, payload):
+    data = [FRAME_START, ord(command)]
+    for b in payload:
+        if b in (FRAME_START, ESCAPE):
+            data += [ESCAPE, b ^ ESCAPE_XOR]
+        else:
+            data.append(b)
+    return data
+
+def send(conn, command, payload=()):
+    for b in frame(command, payload):
+        conn.write(bytes([b]))
+        time.sleep(BYTE_DELAY)
+
+# Reads lines until one starts with one of the prefixes, skipping anything else like the binary
+# sync packets a leader sends between replies. Returns '' if nothing arrives before the timeout
+def read_reply(conn, prefixes=('OK', 'ERR')):
+    while True:
+        line = conn.readline()
+        if not line:
+            return ''
+        text = line.decode('ascii', 'replace').strip()
+        if text.startswith(prefixes):
+            return text
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# glowstick
+# Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+# Assembles a custom animation and uploads it to a glowstick over serial
+# Usage: shader.py <port> <file>, or shader.py --dump <file> to print the bytecode
+# Requires pyserial
+
+import sys
+import time
+
+import glowserial
+
+# Must match ShaderOp in src/shadervm.hpp
+OPS = ['push', 'phase', 'position', 'dup', 'swap', 'add', 'qadd', 'qsub',
+       'sin8', 'scale8', 'color', 'palette']
+MAX_LENGTH = 32
+COMMAND_SHADER = 'S'
+
+def assemble(source):
+    program = []
+    operand = False # the previous word was push
+    number = 0
+    for number, line in enumerate(source.splitlines(), 1):
+        words = line.split('#')[0].split()
+        for word in words:
+            if operand:
+                if not word.isdigit() or int(word) > 255:
+                    raise ValueError('line {}: push needs a number from 0 to 255, got "{}"'.format(
+                        number, word))
+                program.append(int(word))
+                operand = False
+            elif word.lower() in OPS:
+                program.append(OPS.index(word.lower()))
+                operand = word.lower() == 'push'
+            else:
+                raise ValueError('line {}: unexpected "{}"'.format(number, word))
+    if operand:
+        raise ValueError('line {}: push needs a number from 0 to 255'.format(number))
+    if len(program) > MAX_LENGTH:
+        raise ValueError('program is {} bytes, maximum is {}'.format(len(program), MAX_LENGTH))
+    return program
+
+def upload(port, program):
+    import serial
+    with serial.Serial(port, 115200, timeout=2) as conn:
+        time.sleep(2) # Opening the port resets the board
+        conn.reset_input_buffer()
+        glowserial.send(conn, COMMAND_SHADER, [len(program)] + program + [sum(program) & 0xff])
+        return glowserial.read_reply(conn) or 'no reply'
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print('usage: shader.py <port> <file> | shader.py --dump <file>')
+        sys.exit(1)
+    with open(sys.argv[2]) as f:
+        program = assemble(f.read())
+    if sys.argv[1] == '--dump':
+        print(' '.join('{:02x}'.format(b) for b in program))
+    else:
+        print(upload(sys.argv[1], program))
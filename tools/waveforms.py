@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# glowstick
+# Copyright 2020 jackw01. Released under the MIT License (see LICENSE for details).
+
+# Generates the lookup tables in src/waveforms.cpp
+# The rainbow palette has ColorCorrection from src/constants.hpp applied, regenerate it if that changes
+
+import math
+
+COLOR_CORRECTION = (255, 176, 240) # r, g, b
+
+def sine(i):
+    return round(127.5 + 127.5 * math.sin(2 * math.pi * i / 256))
+
+def triangle(i):
+    return 2 * i if i < 128 else 511 - 2 * i
+
+def ease_in_out(i):
+    x = i / 255
+    y = 4 * x ** 3 if x < 0.5 else 1 - (-2 * x + 2) ** 3 / 2
+    return round(255 * y)
+
+def scale8(i, scale):
+    return (i * (1 + scale)) >> 8
+
+# Same as hsv2rgbw() at full saturation
+def hsv2rgbw(hue, val):
+    offset8 = (hue & 0x1f) << 3
+    third = offset8 // 3
+    section = hue >> 5
+    r, g, b = [
+        (255 - third, third, 0),
+        (171, 85 + third, 0),
+        (171 - third * 2, 170 + third, 0),
+        (0, 255 - third, third),
+        (0, 171 - third * 2, 85 + third * 2),
+        (third, 0, 255 - third),
+        (85 + third, 0, 171 - third),
+        (170 + third, 0, 85 - third),
+    ][section]
+    v = (val * val >> 8) + (1 if val else 0)
+    r, g, b = [scale8(scale8(c, v), k) for c, k in zip((r, g, b), COLOR_CORRECTION)]
+    return (g, r, b, 0)
+
+def print_table(name, values):
+    print('const uint8_t {}[256] PROGMEM = {{'.format(name))
+    for row in range(0, 256, 16):
+        print('  ' + ', '.join('{:3}'.format(v) for v in values[row:row + 16]) + ',')
+    print('};\n')
+
+if __name__ == '__main__':
+    print_table('SineTable', [sine(i) for i in range(256)])
+    print_table('TriangleTable', [triangle(i) for i in range(256)])
+    print_table('EaseInOutTable', [ease_in_out(i) for i in range(256)])
+    print('const uint8_t RainbowPalette[16][4] PROGMEM = {')
+    for i in range(16):
+        print('  {' + ', '.join('{:3}'.format(c) for c in hsv2rgbw(i * 16, 128)) + '},')
+    print('};')